@@ -0,0 +1,101 @@
+/**
+ * Heap allocation tracking by malloc interposition.
+ * * Including this header in a solver (in exactly one translation unit, which
+ * every solver is) replaces malloc, calloc, realloc and free for the whole
+ * process, libc included, with wrappers that count calls and bytes and then
+ * forward to glibc's own allocator (__libc_malloc and friends).
+ * Memory obtained through other entry points (posix_memalign, mmap, static
+ * arrays, the stack) is only visible in the peak RSS.
+ * * Every allocation lands in alloc_totals and, if alloc_bucket is set, also
+ * in the AllocStats it returns for the calling thread (common/phase.h uses
+ * it to charge the running phase). All updates are atomic, so worker threads
+ * are counted too.
+ * * Live and peak heap bytes are measured with malloc_usable_size, so they
+ * include allocator rounding; bytes is what the program asked for.
+ */
+#ifndef AOC_ALLOCS_H
+#define AOC_ALLOCS_H
+
+#include <malloc.h>
+#include <stddef.h>
+#include <sys/resource.h>
+
+typedef struct {
+  long long calls; // malloc, calloc and realloc calls
+  long long bytes; // Bytes requested by them
+  long long frees; // free calls, and reallocs that moved the block
+} AllocStats;
+
+static AllocStats alloc_totals;
+static long long alloc_live = 0; // Heap bytes in use
+static long long alloc_peak = 0; // Highest alloc_live so far
+static AllocStats *(*alloc_bucket)(void) = NULL;
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static inline void alloc_count(AllocStats *s, long long calls,
+                               long long bytes, long long frees) {
+  __atomic_fetch_add(&s->calls, calls, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&s->bytes, bytes, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&s->frees, frees, __ATOMIC_RELAXED);
+}
+
+// Records one call: size bytes requested, grown/shrunk the heap by delta
+static inline void alloc_note(long long calls, long long size,
+                              long long frees, long long delta) {
+  alloc_count(&alloc_totals, calls, size, frees);
+  AllocStats *bucket = alloc_bucket ? alloc_bucket() : NULL;
+  if (bucket)
+    alloc_count(bucket, calls, size, frees);
+
+  long long live = __atomic_add_fetch(&alloc_live, delta, __ATOMIC_RELAXED);
+  long long peak = __atomic_load_n(&alloc_peak, __ATOMIC_RELAXED);
+  while (live > peak &&
+         !__atomic_compare_exchange_n(&alloc_peak, &peak, live, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+void *malloc(size_t size) {
+  void *p = __libc_malloc(size);
+  if (p)
+    alloc_note(1, size, 0, malloc_usable_size(p));
+  return p;
+}
+
+void *calloc(size_t count, size_t size) {
+  void *p = __libc_calloc(count, size);
+  if (p)
+    alloc_note(1, (long long)(count * size), 0, malloc_usable_size(p));
+  return p;
+}
+
+void *realloc(void *ptr, size_t size) {
+  long long old = ptr ? (long long)malloc_usable_size(ptr) : 0;
+  void *p = __libc_realloc(ptr, size);
+  if (p)
+    alloc_note(1, size, ptr && p != ptr, malloc_usable_size(p) - old);
+  else if (size == 0 && ptr)
+    alloc_note(0, 0, 1, -old); // realloc(ptr, 0) freed the block
+  return p;
+}
+
+void free(void *ptr) {
+  if (!ptr)
+    return;
+  alloc_note(0, 0, 1, -(long long)malloc_usable_size(ptr));
+  __libc_free(ptr);
+}
+
+/**
+ * Peak resident set size of the process so far, in kilobytes.
+ */
+static inline long alloc_peak_rss_kb(void) {
+  struct rusage ru;
+  return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : -1;
+}
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * Content-addressed cache of solver answers on disk.
+ * * An entry is keyed by (solver id, build hash, input hash): the build hash
+ * is the XXH64 of the solver binary, so rebuilding a solver with any change
+ * never returns a stale answer, and the input hash is the XXH64 of the input
+ * bytes (common/hash.h). Each entry is one file in the cache directory,
+ * named "day8-part1-<build>-<input>", holding the solver's stdout.
+ * * Entries are written to a temporary file and renamed into place, so
+ * concurrent runners (and threads) never read a torn answer. Eviction is
+ * least recently used: a hit refreshes the entry's mtime, and after every
+ * store the oldest entries are removed until both limits (entry count and
+ * total bytes) hold.
+ * * Usage:
+ * Cache c;
+ * cache_open(&c, cache_default_dir(buf, sizeof(buf)), 1000, 64 << 20);
+ * CacheKey k = {"day8/part1", build_hash, input_hash};
+ * if (cache_get(&c, &k, &answer, &len) == 0) ... else cache_put(...);
+ */
+#ifndef AOC_CACHE_H
+#define AOC_CACHE_H
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CACHE_PATH_LEN 4096
+#define CACHE_ENTRY_LEN (CACHE_PATH_LEN + 128) // Directory and entry name
+#define CACHE_MAX_ANSWER (1 << 20) // Larger outputs aren't cached
+
+typedef struct {
+  char dir[CACHE_PATH_LEN];
+  long max_entries;
+  long long max_bytes;
+} Cache;
+
+typedef struct {
+  const char *solver; // "dayN/partM"
+  uint64_t build;     // Hash of the solver binary
+  uint64_t input;     // Hash of the input bytes
+} CacheKey;
+
+/**
+ * $AOC_CACHE_DIR, else $XDG_CACHE_HOME/aoc-2025, else ~/.cache/aoc-2025.
+ */
+static inline const char *cache_default_dir(char *buf, size_t size) {
+  const char *env = getenv("AOC_CACHE_DIR");
+  if (env && *env) {
+    snprintf(buf, size, "%s", env);
+    return buf;
+  }
+  env = getenv("XDG_CACHE_HOME");
+  if (env && *env)
+    snprintf(buf, size, "%s/aoc-2025", env);
+  else
+    snprintf(buf, size, "%s/.cache/aoc-2025",
+             getenv("HOME") ? getenv("HOME") : "/tmp");
+  return buf;
+}
+
+/**
+ * Creates the directory (and its parents) if needed.
+ * @return 0 on success, -1 on failure (errno is set).
+ */
+static inline int cache_open(Cache *c, const char *dir, long max_entries,
+                             long long max_bytes) {
+  snprintf(c->dir, sizeof(c->dir), "%s", dir);
+  c->max_entries = max_entries;
+  c->max_bytes = max_bytes;
+
+  char path[CACHE_PATH_LEN];
+  snprintf(path, sizeof(path), "%s", dir);
+  for (char *p = path + 1; *p; p++) {
+    if (*p != '/')
+      continue;
+    *p = '\0';
+    if (mkdir(path, 0755) != 0 && errno != EEXIST)
+      return -1;
+    *p = '/';
+  }
+  if (mkdir(path, 0755) != 0 && errno != EEXIST)
+    return -1;
+  return 0;
+}
+
+static inline void cache_entry_path(const Cache *c, const CacheKey *k,
+                                    char *path, size_t size) {
+  char solver[64];
+  snprintf(solver, sizeof(solver), "%s", k->solver);
+  for (char *p = solver; *p; p++)
+    if (*p == '/')
+      *p = '-';
+  snprintf(path, size, "%s/%s-%016llx-%016llx", c->dir, solver,
+           (unsigned long long)k->build, (unsigned long long)k->input);
+}
+
+/**
+ * Looks up an answer. On a hit, *data is a malloc'd copy (NUL terminated,
+ * *len bytes without the NUL) and the entry is marked as recently used.
+ * @return 0 on a hit, -1 on a miss.
+ */
+static inline int cache_get(const Cache *c, const CacheKey *k, char **data,
+                            size_t *len) {
+  char path[CACHE_ENTRY_LEN];
+  cache_entry_path(c, k, path, sizeof(path));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size > CACHE_MAX_ANSWER) {
+    close(fd);
+    return -1;
+  }
+  char *buf = malloc(st.st_size + 1);
+  ssize_t got = read(fd, buf, st.st_size);
+  if (got != st.st_size) {
+    free(buf);
+    close(fd);
+    return -1;
+  }
+  buf[got] = '\0';
+  futimens(fd, NULL); // Recently used: protects it from eviction
+  close(fd);
+
+  *data = buf;
+  *len = got;
+  return 0;
+}
+
+typedef struct {
+  char name[256];
+  long long size;
+  struct timespec used;
+} CacheEntry;
+
+static inline int cache_compare_age(const void *a, const void *b) {
+  const CacheEntry *x = a, *y = b;
+  if (x->used.tv_sec != y->used.tv_sec)
+    return x->used.tv_sec < y->used.tv_sec ? -1 : 1;
+  return (x->used.tv_nsec > y->used.tv_nsec) -
+         (x->used.tv_nsec < y->used.tv_nsec);
+}
+
+/**
+ * Removes least recently used entries until the count and size limits hold.
+ * @return The number of entries removed.
+ */
+static inline int cache_evict(const Cache *c) {
+  DIR *d = opendir(c->dir);
+  if (!d)
+    return 0;
+
+  int count = 0, cap = 64;
+  CacheEntry *entries = malloc(cap * sizeof(CacheEntry));
+  long long total = 0;
+  struct dirent *e;
+  while ((e = readdir(d)) != NULL) {
+    if (strncmp(e->d_name, "day", 3) != 0 || strchr(e->d_name, '.'))
+      continue; // Not an entry (., .., temporary files)
+    struct stat st;
+    if (fstatat(dirfd(d), e->d_name, &st, 0) != 0)
+      continue;
+    if (count == cap) {
+      cap *= 2;
+      entries = realloc(entries, cap * sizeof(CacheEntry));
+    }
+    snprintf(entries[count].name, sizeof(entries[count].name), "%s",
+             e->d_name);
+    entries[count].size = st.st_size;
+    entries[count].used = st.st_mtim;
+    total += st.st_size;
+    count++;
+  }
+
+  qsort(entries, count, sizeof(CacheEntry), cache_compare_age);
+  int removed = 0;
+  for (int i = 0; i < count && (count - removed > c->max_entries ||
+                                total > c->max_bytes);
+       i++) {
+    if (unlinkat(dirfd(d), entries[i].name, 0) == 0) {
+      total -= entries[i].size;
+      removed++;
+    }
+  }
+
+  closedir(d);
+  free(entries);
+  return removed;
+}
+
+/**
+ * Stores an answer, then evicts down to the limits.
+ * @return 0 on success, -1 on failure (errno is set).
+ */
+static inline int cache_put(const Cache *c, const CacheKey *k,
+                            const char *data, size_t len) {
+  if (len > CACHE_MAX_ANSWER)
+    return 0;
+  char path[CACHE_ENTRY_LEN], tmp[CACHE_ENTRY_LEN + 32];
+  cache_entry_path(c, k, path, sizeof(path));
+  snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path); // Unique per writer
+
+  int fd = mkstemp(tmp);
+  if (fd < 0)
+    return -1;
+  int ok = fchmod(fd, 0644) == 0 && write(fd, data, len) == (ssize_t)len;
+  if (close(fd) != 0)
+    ok = 0;
+  if (!ok || rename(tmp, path) != 0) {
+    unlink(tmp);
+    return -1;
+  }
+  cache_evict(c);
+  return 0;
+}
+
+#endif
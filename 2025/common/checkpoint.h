@@ -0,0 +1,404 @@
+/**
+ * Checkpointed streaming for fold-style solvers.
+ * * A fold-style solver reads its input line by line and keeps a small state
+ * (day 1: dial position and zero hits; day 3 or day 6: a running total). If
+ * the input only ever grows, the state after N bytes plus those N bytes is
+ * all that is needed to continue, so each run only has to read the tail.
+ * * The checkpoint file holds:
+ * - a header: magic, solver tag, identity of the input file (device and
+ * inode), the byte offset consumed so far (always at a line boundary) and
+ * the XXH64 of the bytes before it;
+ * - the solver's state as an opaque blob of state_size bytes.
+ * It is written to a temporary file and renamed over the old one, so a
+ * crash never leaves a torn checkpoint. A checkpoint that doesn't match
+ * (other tag or state size, other file, a file now shorter than the offset,
+ * or a prefix that hashes differently, i.e. rewritten in place) is ignored
+ * and the input is read from the start. Checking the prefix reads it again,
+ * but hashing runs far faster than folding. Without a
+ * checkpoint_path it is kept next to the input, named after the tag
+ * (log.txt.day1-part1.ckpt), so each solver of the same log has its own.
+ * * Usage:
+ * Stream s = {.input_path = ..., .checkpoint_path = ..., .tag = "day1/part1",
+ * .state = &state, .state_size = sizeof(state), .init = ..., .fold = ...,
+ * .report = ...};
+ * return stream_run(&s, follow);
+ * fold() receives whole lines (the data ends with '\n'). A last line
+ * without '\n' is folded at the end of the input, after the checkpoint is
+ * saved (so a later run reads it again, grown or not). With follow set, it
+ * is left for the next update instead, and the input is watched with
+ * inotify (polled once a second elsewhere): every append is folded in and
+ * reported, like tail -f. If the file shrinks below
+ * what was read (truncated) or the path now names another file (rotated),
+ * the state is reset and the new contents are read from the start.
+ * * Header-only: include it from the solver, no extra object to link.
+ */
+#ifndef AOC_CHECKPOINT_H
+#define AOC_CHECKPOINT_H
+
+#include "hash.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#define CHECKPOINT_MAGIC "AOCCKPT2"
+#define CHECKPOINT_TAG_LEN 32
+#define STREAM_BLOCK (1 << 24) // Bytes read per fold() call
+
+typedef struct {
+  char magic[8];
+  char tag[CHECKPOINT_TAG_LEN]; // Solver name, NUL padded
+  uint64_t dev;                 // Input file identity
+  uint64_t ino;
+  uint64_t offset;      // Input bytes already folded into the state
+  uint64_t prefix_hash; // XXH64 of those bytes
+  uint32_t state_size;  // Size of the state blob that follows
+  uint32_t reserved;
+} CheckpointHeader;
+
+typedef struct {
+  const char *input_path;
+  const char *checkpoint_path; // NULL: <input_path>.<tag>.ckpt
+  const char *tag;
+  void *state;
+  size_t state_size;
+  void (*init)(void *state); // Fresh state for an empty input
+  void (*fold)(void *state, const char *data, size_t len);
+  void (*report)(const void *state);
+} Stream;
+
+/**
+ * Loads a checkpoint matching tag, state_size and the input file st. The
+ * caller still has to check *prefix_hash against the input.
+ * @return The offset to resume from, or -1 if there is no usable checkpoint.
+ */
+static long long checkpoint_load(const char *path, const char *tag,
+                                 void *state, size_t state_size,
+                                 const struct stat *st,
+                                 uint64_t *prefix_hash) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+
+  CheckpointHeader h;
+  long long offset = -1;
+  if (fread(&h, sizeof(h), 1, f) == 1 &&
+      memcmp(h.magic, CHECKPOINT_MAGIC, 8) == 0 &&
+      strncmp(h.tag, tag, CHECKPOINT_TAG_LEN) == 0 &&
+      h.state_size == state_size && h.dev == (uint64_t)st->st_dev &&
+      h.ino == (uint64_t)st->st_ino && h.offset <= (uint64_t)st->st_size &&
+      fread(state, state_size, 1, f) == 1)
+    offset = (long long)h.offset;
+  *prefix_hash = h.prefix_hash;
+  fclose(f);
+  return offset;
+}
+
+/**
+ * Writes a checkpoint atomically (temporary file + rename).
+ * @return 0 on success, -1 on failure (errno is set).
+ */
+static int checkpoint_save(const char *path, const char *tag,
+                           const void *state, size_t state_size,
+                           const struct stat *st, long long offset,
+                           uint64_t prefix_hash) {
+  CheckpointHeader h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, CHECKPOINT_MAGIC, 8);
+  strncpy(h.tag, tag, CHECKPOINT_TAG_LEN - 1);
+  h.dev = st->st_dev;
+  h.ino = st->st_ino;
+  h.offset = offset;
+  h.prefix_hash = prefix_hash;
+  h.state_size = state_size;
+
+  size_t len = strlen(path);
+  char *tmp = malloc(len + 5);
+  memcpy(tmp, path, len);
+  memcpy(tmp + len, ".tmp", 5);
+
+  FILE *f = fopen(tmp, "wb");
+  int ok = f && fwrite(&h, sizeof(h), 1, f) == 1 &&
+           fwrite(state, state_size, 1, f) == 1;
+  if (f && fclose(f) != 0)
+    ok = 0;
+  if (ok && rename(tmp, path) != 0)
+    ok = 0;
+  if (!ok)
+    unlink(tmp);
+  free(tmp);
+  return ok ? 0 : -1;
+}
+
+/**
+ * Hashes the first len bytes of fd into h.
+ * @return 0 on success, -1 on a read error or if fd is shorter than len.
+ */
+static int stream_hash_prefix(int fd, long long len, Hash64 *h) {
+  char *buf = malloc(STREAM_BLOCK);
+  long long pos = 0;
+  while (pos < len) {
+    size_t want = len - pos < STREAM_BLOCK ? len - pos : STREAM_BLOCK;
+    ssize_t n = pread(fd, buf, want, pos);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+    hash64_update(h, buf, n);
+    pos += n;
+  }
+  free(buf);
+  return pos == len ? 0 : -1;
+}
+
+/**
+ * Folds everything from *offset to the last complete line of fd into the
+ * state, advancing *offset and hashing the folded bytes into prefix. *seen
+ * is set to the end of the data read, including a trailing partial line
+ * that was not folded.
+ * @return 0 on success, -1 on a read error.
+ */
+static int stream_update(Stream *s, int fd, long long *offset,
+                         long long *seen, Hash64 *prefix) {
+  char *buf = malloc(STREAM_BLOCK);
+  size_t used = 0; // Partial line carried over from the previous block
+  long long pos = *offset;
+
+  for (;;) {
+    ssize_t n = pread(fd, buf + used, STREAM_BLOCK - used, pos + used);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      free(buf);
+      return -1;
+    }
+    used += n;
+
+    // Hand over whole lines only
+    size_t whole = used;
+    while (whole > 0 && buf[whole - 1] != '\n')
+      whole--;
+    if (whole == 0 && used == STREAM_BLOCK) {
+      // One line longer than a block: fold it as is
+      whole = used;
+    }
+    if (whole > 0) {
+      s->fold(s->state, buf, whole);
+      hash64_update(prefix, buf, whole);
+      pos += whole;
+      memmove(buf, buf + whole, used - whole);
+      used -= whole;
+    }
+    if (n == 0)
+      break;
+  }
+
+  free(buf);
+  *offset = pos;
+  *seen = pos + used;
+  return 0;
+}
+
+/**
+ * Folds the partial line between offset and seen, once no more input is
+ * coming. The checkpoint must already be saved: the state then covers a
+ * line that may still grow.
+ * @return 0 on success, -1 on a read error.
+ */
+static int stream_finish(Stream *s, int fd, long long offset,
+                         long long seen) {
+  size_t len = seen - offset, got = 0;
+  if (len == 0)
+    return 0;
+  char *buf = malloc(len);
+  while (got < len) {
+    ssize_t n = pread(fd, buf + got, len - got, offset + got);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+    got += n;
+  }
+  if (got > 0)
+    s->fold(s->state, buf, got);
+  free(buf);
+  return got == len ? 0 : -1;
+}
+
+/**
+ * Default checkpoint path for an input: <input>.<tag>.ckpt, with the tag's
+ * '/' turned into '-'.
+ * @return The path (malloc'd).
+ */
+static char *checkpoint_default_path(const char *input_path,
+                                     const char *tag) {
+  size_t len = strlen(input_path) + strlen(tag) + 7;
+  char *path = malloc(len);
+  snprintf(path, len, "%s.%s.ckpt", input_path, tag);
+  for (char *c = path + strlen(input_path); *c; c++)
+    if (*c == '/')
+      *c = '-';
+  return path;
+}
+
+#ifdef __linux__
+// inotify descriptor watching path for appends, truncation and rotation,
+// or -1 (then the caller polls)
+static int stream_watch(const char *path) {
+  int watch = inotify_init1(0);
+  uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF |
+                  IN_DELETE_SELF;
+  if (watch >= 0 && inotify_add_watch(watch, path, mask) < 0) {
+    close(watch);
+    watch = -1;
+  }
+  return watch;
+}
+#endif
+
+/**
+ * Resumes from the checkpoint (if any), folds the new tail, saves the
+ * checkpoint and reports. With follow set, keeps doing so on every append.
+ * @return Exit status for main().
+ */
+static int stream_run(Stream *s, int follow) {
+  int fd = open(s->input_path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "Error: cannot open '%s': %s\n", s->input_path,
+            strerror(errno));
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    fprintf(stderr, "Error: cannot stat '%s': %s\n", s->input_path,
+            strerror(errno));
+    close(fd);
+    return 1;
+  }
+
+  char *default_path = NULL;
+  const char *checkpoint_path = s->checkpoint_path;
+  if (!checkpoint_path)
+    checkpoint_path = default_path =
+        checkpoint_default_path(s->input_path, s->tag);
+
+  // prefix: hash of the bytes folded into the state, kept up to date
+  Hash64 prefix;
+  hash64_init(&prefix, 0);
+  uint64_t saved_hash = 0;
+  long long offset = checkpoint_load(checkpoint_path, s->tag, s->state,
+                                     s->state_size, &st, &saved_hash);
+  if (offset >= 0 && (stream_hash_prefix(fd, offset, &prefix) != 0 ||
+                      hash64_final(&prefix) != saved_hash)) {
+    // Rewritten in place: the state describes other bytes
+    hash64_init(&prefix, 0);
+    offset = -1;
+  }
+  if (offset < 0) {
+    s->init(s->state);
+    offset = 0;
+  }
+
+#ifdef __linux__
+  int watch = follow ? stream_watch(s->input_path) : -1;
+#endif
+
+  long long seen;
+  for (;;) {
+    int failed = stream_update(s, fd, &offset, &seen, &prefix) != 0;
+    if (!failed &&
+        checkpoint_save(checkpoint_path, s->tag, s->state, s->state_size, &st,
+                        offset, hash64_final(&prefix)) != 0)
+      fprintf(stderr, "Warning: cannot write checkpoint '%s': %s\n",
+              checkpoint_path, strerror(errno));
+    if (!failed && !follow)
+      failed = stream_finish(s, fd, offset, seen) != 0;
+    if (failed) {
+      fprintf(stderr, "Error: reading '%s': %s\n", s->input_path,
+              strerror(errno));
+      close(fd);
+      free(default_path);
+      return 1;
+    }
+    s->report(s->state);
+    fflush(stdout);
+    if (!follow)
+      break;
+
+    // Wait until the file grows, shrinks or is replaced
+    for (;;) {
+#ifdef __linux__
+      if (watch >= 0) {
+        // Also wake once a second: after a rotation the watch is on the old
+        // file, and the new one may not exist yet when it fires
+        struct pollfd p = {.fd = watch, .events = POLLIN};
+        char events[4096];
+        int ready = poll(&p, 1, 1000);
+        if (ready > 0 && read(watch, events, sizeof(events)) < 0 &&
+            errno != EINTR) {
+          close(watch); // Fall back to polling
+          watch = -1;
+        }
+      } else {
+        sleep(1);
+      }
+#else
+      sleep(1);
+#endif
+      struct stat now;
+      if (stat(s->input_path, &now) == 0 &&
+          (now.st_dev != st.st_dev || now.st_ino != st.st_ino)) {
+        // Rotated: follow the new file from its start
+        int next = open(s->input_path, O_RDONLY);
+        if (next < 0)
+          continue;
+        if (fstat(next, &now) != 0) {
+          close(next);
+          continue;
+        }
+        close(fd);
+        fd = next;
+        st = now;
+#ifdef __linux__
+        if (watch >= 0)
+          close(watch);
+        watch = stream_watch(s->input_path);
+#endif
+        s->init(s->state);
+        hash64_init(&prefix, 0);
+        offset = 0;
+        break;
+      }
+      if (fstat(fd, &now) != 0)
+        continue;
+      if (now.st_size < seen) {
+        // Truncated: what was folded is gone, so start over
+        s->init(s->state);
+        hash64_init(&prefix, 0);
+        offset = 0;
+        break;
+      }
+      if (now.st_size > seen)
+        break;
+    }
+  }
+
+#ifdef __linux__
+  if (watch >= 0)
+    close(watch);
+#endif
+  close(fd);
+  free(default_path);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * Hardware performance counters through perf_event_open(2).
+ * * Counts, for this process and every thread it starts after
+ * counters_open(), in user space only:
+ * cycles, instructions, L1 data cache read misses, last-level cache misses
+ * and branch misses.
+ * * Each counter is opened on its own, so a machine that lacks one (or a
+ * container that forbids them all, as with perf_event_paranoid or a VM
+ * without a PMU) only loses what it can't count: those values read as -1
+ * and the caller falls back to its wall-clock time. When the kernel has to
+ * multiplex counters, values are scaled by time enabled / time running.
+ * * Thread counts are folded into the process totals when the threads exit,
+ * so read around regions that join their workers.
+ * * Usage:
+ * Counters c;
+ * CounterValues before, after;
+ * counters_open(&c);
+ * counters_read(&c, &before);
+ * ... hot phase ...
+ * counters_read(&c, &after); // after.v[i] - before.v[i], unless -1
+ * counters_close(&c);
+ */
+#ifndef AOC_COUNTERS_H
+#define AOC_COUNTERS_H
+
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+enum {
+  COUNTER_CYCLES,
+  COUNTER_INSTRUCTIONS,
+  COUNTER_L1D_MISSES,
+  COUNTER_LLC_MISSES,
+  COUNTER_BRANCH_MISSES,
+  NUM_COUNTERS
+};
+
+static const char *const COUNTER_NAMES[NUM_COUNTERS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+typedef struct {
+  int fd[NUM_COUNTERS]; // -1: not available
+} Counters;
+
+typedef struct {
+  long long v[NUM_COUNTERS]; // -1: not available
+} CounterValues;
+
+/**
+ * Opens every counter this machine allows.
+ * @return The number of counters that are available (0 to NUM_COUNTERS).
+ */
+static inline int counters_open(Counters *c) {
+  int opened = 0;
+  for (int i = 0; i < NUM_COUNTERS; i++)
+    c->fd[i] = -1;
+#ifdef __linux__
+  static const struct {
+    unsigned type;
+    unsigned long long config;
+  } events[NUM_COUNTERS] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  };
+  for (int i = 0; i < NUM_COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = events[i].type;
+    attr.config = events[i].config;
+    attr.inherit = 1; // Threads started from now on count too
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    c->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (c->fd[i] >= 0)
+      opened++;
+  }
+#endif
+  return opened;
+}
+
+static inline void counters_read(const Counters *c, CounterValues *out) {
+  for (int i = 0; i < NUM_COUNTERS; i++) {
+    out->v[i] = -1;
+    unsigned long long buf[3]; // value, time enabled, time running
+    if (c->fd[i] < 0 || read(c->fd[i], buf, sizeof(buf)) != sizeof(buf))
+      continue;
+    if (buf[2] == 0)
+      out->v[i] = 0; // Never scheduled on a PMU
+    else if (buf[2] < buf[1])
+      out->v[i] = (long long)((double)buf[0] * buf[1] / buf[2]);
+    else
+      out->v[i] = (long long)buf[0];
+  }
+}
+
+static inline void counters_close(Counters *c) {
+  for (int i = 0; i < NUM_COUNTERS; i++) {
+    if (c->fd[i] >= 0)
+      close(c->fd[i]);
+    c->fd[i] = -1;
+  }
+}
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * XXH64 (xxHash, 64-bit), streaming and one-shot, plus a helper that hashes
+ * a whole file through mmap.
+ * * Output matches the reference xxHash implementation, so keys can be
+ * checked with xxhsum -H64. Not cryptographic: it identifies inputs, it
+ * doesn't defend against crafted collisions.
+ * * Usage:
+ * Hash64 h;
+ * hash64_init(&h, 0);
+ * hash64_update(&h, data, len); // Any number of times
+ * uint64_t digest = hash64_final(&h);
+ */
+#ifndef AOC_HASH_H
+#define AOC_HASH_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HASH64_P1 0x9E3779B185EBCA87ULL
+#define HASH64_P2 0xC2B2AE3D27D4EB4FULL
+#define HASH64_P3 0x165667B19E3779F9ULL
+#define HASH64_P4 0x85EBCA77C2B2AE63ULL
+#define HASH64_P5 0x27D4EB2F165667C5ULL
+
+typedef struct {
+  uint64_t v[4];         // The four lanes
+  uint64_t total;        // Bytes hashed so far
+  unsigned char buf[32]; // Tail that doesn't fill a 32-byte stripe yet
+  size_t buffered;
+  uint64_t seed;
+} Hash64;
+
+static inline uint64_t hash64_rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash64_read64(const unsigned char *p) {
+  uint64_t v;
+  memcpy(&v, p, 8); // Little-endian hosts only, like the solvers
+  return v;
+}
+
+static inline uint64_t hash64_round(uint64_t acc, uint64_t input) {
+  acc += input * HASH64_P2;
+  return hash64_rotl(acc, 31) * HASH64_P1;
+}
+
+static inline uint64_t hash64_merge(uint64_t acc, uint64_t lane) {
+  acc ^= hash64_round(0, lane);
+  return acc * HASH64_P1 + HASH64_P4;
+}
+
+static inline void hash64_init(Hash64 *h, uint64_t seed) {
+  h->v[0] = seed + HASH64_P1 + HASH64_P2;
+  h->v[1] = seed + HASH64_P2;
+  h->v[2] = seed;
+  h->v[3] = seed - HASH64_P1;
+  h->total = 0;
+  h->buffered = 0;
+  h->seed = seed;
+}
+
+// Consumes whole 32-byte stripes from p; returns the bytes consumed
+static inline size_t hash64_stripes(Hash64 *h, const unsigned char *p,
+                                    size_t len) {
+  uint64_t v0 = h->v[0], v1 = h->v[1], v2 = h->v[2], v3 = h->v[3];
+  size_t done = 0;
+  for (; done + 32 <= len; done += 32) {
+    v0 = hash64_round(v0, hash64_read64(p + done));
+    v1 = hash64_round(v1, hash64_read64(p + done + 8));
+    v2 = hash64_round(v2, hash64_read64(p + done + 16));
+    v3 = hash64_round(v3, hash64_read64(p + done + 24));
+  }
+  h->v[0] = v0;
+  h->v[1] = v1;
+  h->v[2] = v2;
+  h->v[3] = v3;
+  return done;
+}
+
+static inline void hash64_update(Hash64 *h, const void *data, size_t len) {
+  const unsigned char *p = data;
+  h->total += len;
+
+  if (h->buffered > 0) {
+    size_t fill = 32 - h->buffered < len ? 32 - h->buffered : len;
+    memcpy(h->buf + h->buffered, p, fill);
+    h->buffered += fill;
+    p += fill;
+    len -= fill;
+    if (h->buffered < 32)
+      return;
+    hash64_stripes(h, h->buf, 32);
+    h->buffered = 0;
+  }
+
+  size_t done = hash64_stripes(h, p, len);
+  memcpy(h->buf, p + done, len - done);
+  h->buffered = len - done;
+}
+
+static inline uint64_t hash64_final(const Hash64 *h) {
+  uint64_t acc;
+  if (h->total >= 32) {
+    acc = hash64_rotl(h->v[0], 1) + hash64_rotl(h->v[1], 7) +
+          hash64_rotl(h->v[2], 12) + hash64_rotl(h->v[3], 18);
+    for (int i = 0; i < 4; i++)
+      acc = hash64_merge(acc, h->v[i]);
+  } else {
+    acc = h->seed + HASH64_P5;
+  }
+  acc += h->total;
+
+  const unsigned char *p = h->buf;
+  size_t len = h->buffered;
+  for (; len >= 8; p += 8, len -= 8) {
+    acc ^= hash64_round(0, hash64_read64(p));
+    acc = hash64_rotl(acc, 27) * HASH64_P1 + HASH64_P4;
+  }
+  if (len >= 4) {
+    uint32_t w;
+    memcpy(&w, p, 4);
+    acc ^= (uint64_t)w * HASH64_P1;
+    acc = hash64_rotl(acc, 23) * HASH64_P2 + HASH64_P3;
+    p += 4;
+    len -= 4;
+  }
+  for (; len > 0; p++, len--) {
+    acc ^= *p * HASH64_P5;
+    acc = hash64_rotl(acc, 11) * HASH64_P1;
+  }
+
+  acc ^= acc >> 33;
+  acc *= HASH64_P2;
+  acc ^= acc >> 29;
+  acc *= HASH64_P3;
+  acc ^= acc >> 32;
+  return acc;
+}
+
+static inline uint64_t hash64(const void *data, size_t len, uint64_t seed) {
+  Hash64 h;
+  hash64_init(&h, seed);
+  hash64_update(&h, data, len);
+  return hash64_final(&h);
+}
+
+/**
+ * Hashes the file at path (mapped, or read when it can't be mapped).
+ * @return 0 on success, -1 if it can't be opened or read.
+ */
+static inline int hash64_file(const char *path, uint64_t *digest) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  Hash64 h;
+  hash64_init(&h, 0);
+  void *map = st.st_size > 0
+                  ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)
+                  : MAP_FAILED;
+  if (map != MAP_FAILED) {
+    hash64_update(&h, map, st.st_size);
+    munmap(map, st.st_size);
+  } else {
+    unsigned char buf[1 << 16];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+      hash64_update(&h, buf, n);
+    if (n < 0) {
+      close(fd);
+      return -1;
+    }
+  }
+  close(fd);
+  *digest = hash64_final(&h);
+  return 0;
+}
+
+#endif
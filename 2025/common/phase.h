@@ -0,0 +1,307 @@
+/**
+ * Phase markers for benchmarking the solvers.
+ * * Two kinds of marker:
+ * - PHASE_MARK("build") ends the current top-level phase and starts the next
+ * one, so a solver is split into parse / build / solve without moving any
+ * code around. Call it from the main thread only.
+ * - PHASE("sort") stmt times one statement or block, nested inside the
+ * phase that is running around it; it is reported as "build/sort". Don't
+ * leave the statement with break, continue or return. PHASE works from any
+ * thread: on a worker it nests under the current top-level phase, and the
+ * times of all threads add up (so "solve/gauss" can exceed "solve").
+ * A phase that runs repeatedly is reported once, with its count and total.
+ * * Built with -DAOC_PHASES, the totals are written at exit, one line per
+ * phase: "phase<TAB>name<TAB>count<TAB>nanoseconds", to the file named by
+ * $AOC_PHASE_FILE (appended) or to stderr. Without it, both markers compile
+ * to nothing: PHASE("sort") qsort(...); is just qsort(...);.
+ * * -DAOC_COUNTERS (which implies AOC_PHASES) adds hardware counters from
+ * common/counters.h to phases that start and end on the main thread. Each
+ * phase line is then followed by
+ * "counters<TAB>name<TAB>cycles<TAB>instructions<TAB>l1d_misses<TAB>
+ * llc_misses<TAB>branch_misses", with "-" for whatever couldn't be counted:
+ * counters the machine doesn't offer (often all of them in containers) and
+ * phases that only ran on worker threads. Their wall time is still in the
+ * phase line.
+ * * -DAOC_ALLOCS (which also implies AOC_PHASES) tracks the heap through
+ * common/allocs.h. Each phase line is followed by
+ * "allocs<TAB>name<TAB>calls<TAB>bytes<TAB>frees" for the calls made while
+ * that phase was the innermost one, on any thread; "allocs<TAB>-" counts
+ * those made outside every phase. The report ends with
+ * "memory<TAB>peak_rss_kb<TAB>N" (getrusage), "memory<TAB>peak_heap_bytes
+ * <TAB>N" and "memory<TAB>top_phase<TAB>name", the phase that allocated the
+ * most bytes ("-" if that was outside every phase). The report is written
+ * even if the solver has no markers.
+ */
+#ifndef AOC_PHASE_H
+#define AOC_PHASE_H
+
+#if (defined(AOC_COUNTERS) || defined(AOC_ALLOCS)) && !defined(AOC_PHASES)
+#define AOC_PHASES
+#endif
+
+#ifdef AOC_PHASES
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef AOC_COUNTERS
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "counters.h"
+#endif
+#ifdef AOC_ALLOCS
+#include "allocs.h"
+#endif
+
+#define PHASE_MAX 64
+#define PHASE_OUTSIDE (-2) // Thread not inside a PHASE: nest under the mark
+
+typedef struct {
+  const char *name;
+  int parent; // Index of the enclosing phase, -1 at top level
+  long long count;
+  long long total_ns;
+#ifdef AOC_COUNTERS
+  int counted;                // Ran on the main thread at least once
+  int missing;                // Bit i: counter i wasn't available
+  long long hw[NUM_COUNTERS]; // Counter totals
+#endif
+#ifdef AOC_ALLOCS
+  AllocStats allocs;
+#endif
+} PhaseEntry;
+
+static PhaseEntry phase_table[PHASE_MAX];
+static int phase_count = 0;
+static int phase_started = 0; // Report registered, counters opened
+static char phase_lock = 0; // Guards phase_count and new entries
+static int phase_top = -1;  // Running PHASE_MARK phase
+static long long phase_top_start;
+static _Thread_local int phase_current = PHASE_OUTSIDE;
+
+#ifdef AOC_COUNTERS
+static Counters phase_counters;
+static CounterValues phase_top_hw;
+
+// Counters only see the threads of the process once they have exited, so
+// only phases on the main thread get them. start is left at -1 elsewhere.
+static inline void phase_hw_start(CounterValues *start) {
+  if (syscall(SYS_gettid) == getpid())
+    counters_read(&phase_counters, start);
+  else
+    for (int k = 0; k < NUM_COUNTERS; k++)
+      start->v[k] = -1;
+}
+
+static inline void phase_hw_add(int i, const CounterValues *start) {
+  if (syscall(SYS_gettid) != getpid())
+    return;
+  CounterValues end;
+  counters_read(&phase_counters, &end);
+  phase_table[i].counted = 1;
+  for (int k = 0; k < NUM_COUNTERS; k++) {
+    if (start->v[k] < 0 || end.v[k] < 0)
+      phase_table[i].missing |= 1 << k;
+    else
+      phase_table[i].hw[k] += end.v[k] - start->v[k];
+  }
+}
+#endif
+
+static inline long long phase_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline void phase_add(int i, long long start) {
+  __atomic_fetch_add(&phase_table[i].total_ns, phase_now_ns() - start,
+                     __ATOMIC_RELAXED);
+  __atomic_fetch_add(&phase_table[i].count, 1, __ATOMIC_RELAXED);
+}
+
+static inline void phase_path(FILE *f, int i) {
+  if (phase_table[i].parent >= 0) {
+    phase_path(f, phase_table[i].parent);
+    fputc('/', f);
+  }
+  fputs(phase_table[i].name, f);
+}
+
+static inline void phase_report(void) {
+  if (phase_top >= 0) {
+    phase_add(phase_top, phase_top_start);
+#ifdef AOC_COUNTERS
+    phase_hw_add(phase_top, &phase_top_hw);
+#endif
+  }
+#ifdef AOC_ALLOCS
+  // Snapshot before the report's own allocations (fopen)
+  alloc_bucket = NULL;
+  AllocStats outside = alloc_totals;
+  long long peak_heap = alloc_peak;
+  int top = -1;
+  for (int i = 0; i < phase_count; i++) {
+    outside.calls -= phase_table[i].allocs.calls;
+    outside.bytes -= phase_table[i].allocs.bytes;
+    outside.frees -= phase_table[i].allocs.frees;
+    if (top < 0 || phase_table[i].allocs.bytes > phase_table[top].allocs.bytes)
+      top = i;
+  }
+#endif
+  const char *path = getenv("AOC_PHASE_FILE");
+  FILE *f = path ? fopen(path, "a") : NULL;
+  FILE *out = f ? f : stderr;
+  for (int i = 0; i < phase_count; i++) {
+    fputs("phase\t", out);
+    phase_path(out, i);
+    fprintf(out, "\t%lld\t%lld\n", phase_table[i].count,
+            phase_table[i].total_ns);
+#ifdef AOC_COUNTERS
+    fputs("counters\t", out);
+    phase_path(out, i);
+    for (int k = 0; k < NUM_COUNTERS; k++) {
+      if (!phase_table[i].counted || phase_table[i].missing >> k & 1)
+        fputs("\t-", out);
+      else
+        fprintf(out, "\t%lld", phase_table[i].hw[k]);
+    }
+    fputc('\n', out);
+#endif
+#ifdef AOC_ALLOCS
+    fputs("allocs\t", out);
+    phase_path(out, i);
+    fprintf(out, "\t%lld\t%lld\t%lld\n", phase_table[i].allocs.calls,
+            phase_table[i].allocs.bytes, phase_table[i].allocs.frees);
+#endif
+  }
+#ifdef AOC_ALLOCS
+  fprintf(out, "allocs\t-\t%lld\t%lld\t%lld\n", outside.calls, outside.bytes,
+          outside.frees);
+  fprintf(out, "memory\tpeak_rss_kb\t%ld\n", alloc_peak_rss_kb());
+  fprintf(out, "memory\tpeak_heap_bytes\t%lld\n", peak_heap);
+  fputs("memory\ttop_phase\t", out);
+  if (top >= 0 && phase_table[top].allocs.bytes >= outside.bytes)
+    phase_path(out, top);
+  else
+    fputc('-', out);
+  fputc('\n', out);
+#endif
+  if (f)
+    fclose(f);
+}
+
+static inline void phase_start_once(void) {
+  if (phase_started)
+    return;
+  phase_started = 1;
+  atexit(phase_report);
+#ifdef AOC_COUNTERS
+  counters_open(&phase_counters);
+#endif
+}
+
+#ifdef AOC_ALLOCS
+// Allocations are charged to the innermost phase of the calling thread
+static inline AllocStats *phase_alloc_bucket(void) {
+  int i = phase_current == PHASE_OUTSIDE ? phase_top : phase_current;
+  return i >= 0 ? &phase_table[i].allocs : NULL;
+}
+
+// The report also has to come out for solvers without markers
+__attribute__((constructor)) static void phase_alloc_init(void) {
+  alloc_bucket = phase_alloc_bucket;
+  phase_start_once();
+}
+#endif
+
+// Finds or adds the phase name under parent. Returns -1 if the table is full
+// (the phase then goes untimed).
+static inline int phase_enter(const char *name, int parent) {
+  while (__atomic_test_and_set(&phase_lock, __ATOMIC_ACQUIRE))
+    ;
+  phase_start_once();
+  int i = 0;
+  while (i < phase_count && (phase_table[i].parent != parent ||
+                             strcmp(phase_table[i].name, name) != 0))
+    i++;
+  if (i == phase_count) {
+    if (phase_count < PHASE_MAX)
+      phase_table[phase_count++] = (PhaseEntry){.name = name, .parent = parent};
+    else
+      i = -1;
+  }
+  __atomic_clear(&phase_lock, __ATOMIC_RELEASE);
+  return i;
+}
+
+static inline void phase_mark(const char *name) {
+  if (phase_top >= 0) {
+    phase_add(phase_top, phase_top_start);
+#ifdef AOC_COUNTERS
+    phase_hw_add(phase_top, &phase_top_hw);
+#endif
+  }
+  phase_top = phase_enter(name, -1);
+#ifdef AOC_COUNTERS
+  phase_hw_start(&phase_top_hw);
+#endif
+  phase_top_start = phase_now_ns();
+  phase_current = PHASE_OUTSIDE;
+}
+
+// Scope of one PHASE statement; the for loop in PHASE runs its body once
+typedef struct {
+  int self;
+  int saved; // phase_current to restore
+  int open;
+  long long start;
+#ifdef AOC_COUNTERS
+  CounterValues hw;
+#endif
+} PhaseScope;
+
+static inline PhaseScope phase_begin(const char *name) {
+  int parent = phase_current == PHASE_OUTSIDE ? phase_top : phase_current;
+  PhaseScope s = {.self = phase_enter(name, parent),
+                  .saved = phase_current,
+                  .open = 1};
+  if (s.self >= 0)
+    phase_current = s.self;
+#ifdef AOC_COUNTERS
+  phase_hw_start(&s.hw);
+#endif
+  s.start = phase_now_ns();
+  return s;
+}
+
+static inline void phase_end(PhaseScope *s) {
+  if (s->self >= 0) {
+    phase_add(s->self, s->start);
+#ifdef AOC_COUNTERS
+    phase_hw_add(s->self, &s->hw);
+#endif
+  }
+  phase_current = s->saved;
+  s->open = 0;
+}
+
+#define PHASE_CONCAT2(a, b) a##b
+#define PHASE_CONCAT(a, b) PHASE_CONCAT2(a, b)
+#define PHASE_SCOPE PHASE_CONCAT(phase_scope_, __LINE__)
+
+#define PHASE_MARK(name) phase_mark(name)
+#define PHASE(name)                                                            \
+  for (PhaseScope PHASE_SCOPE = phase_begin(name); PHASE_SCOPE.open;           \
+       phase_end(&PHASE_SCOPE))
+
+#else
+
+#define PHASE_MARK(name) ((void)0)
+#define PHASE(name)
+
+#endif
+
+#endif
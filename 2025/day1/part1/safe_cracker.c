@@ -1,34 +1,294 @@
+// Build: gcc -O2 -march=native -pthread safe_cracker.c
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
-int main() {
-  // The dial starts pointing at 50
-  int current_pos = 50;
-  int zero_hits = 0;
-
-  char direction;
-  int distance;
-
-  // Read input line by line.
-  while (scanf(" %c%d", &direction, &distance) == 2) {
-
-    if (direction == 'R') {
-      // Right goes toward higher numbers
-      current_pos = (current_pos + distance) % 100;
-    } else if (direction == 'L') {
-      // Left goes toward lower numbers
-      current_pos = (current_pos - distance) % 100;
-      if (current_pos < 0) {
-        current_pos += 100;
+#include "../../common/checkpoint.h"
+#include "../../common/phase.h"
+
+#define DIAL 100
+#define MAX_THREADS 64
+#define MIN_CHUNK_BYTES (1 << 20) // Below this per thread, fewer threads
+#define STREAM_TAG "day1/part1"   // Checkpoint tag for stream mode
+
+// What a run of rotations does to the dial, for every possible start.
+// Rotations compose by adding offsets mod 100, so chunks can be summarized
+// independently and chained afterwards.
+typedef struct {
+  int offset;           // Net rotation of the chunk (0..99)
+  long long hits[DIAL]; // hits[s] = zero landings when starting at s
+} Summary;
+
+typedef struct {
+  const char *begin;
+  const char *end;
+  Summary summary;
+} Chunk;
+
+// Running state while scanning a chunk
+typedef struct {
+  int prefix;             // Net rotation so far (0..99)
+  long long landed[DIAL]; // landed[v] = rotations that ended with prefix v
+} Scan;
+
+// x / 100 for any 32-bit x, as a multiply-high instead of a division
+static inline uint32_t div100(uint32_t x) {
+  return (uint32_t)(((uint64_t)x * 0x51EB851Fu) >> 37);
+}
+
+// Apply one rotation without branches; returns the new prefix
+static inline int step(int prefix, long long *landed, int is_left,
+                       uint32_t distance) {
+  int remainder = distance - DIAL * div100(distance);
+  int delta = is_left ? DIAL - remainder : remainder; // cmov, 1..100
+  int next = prefix + delta;
+  next -= (next >= DIAL) * DIAL;
+  landed[next]++;
+  return next;
+}
+
+// General parser for [begin, end): tolerates blank lines, stray bytes and
+// long numbers
+void scan_scalar(Scan *sc, const char *begin, const char *end) {
+  const char *p = begin;
+  while (p < end) {
+    char direction = *p++;
+    if (direction != 'L' && direction != 'R')
+      continue;
+    uint32_t distance = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+      distance = distance * 10 + (*p++ - '0');
+    sc->prefix = step(sc->prefix, sc->landed, direction == 'L', distance);
+  }
+}
+
+#ifdef __AVX2__
+// Parse len (1..8) ASCII digits at p in-register, without branches. Reads 8
+// bytes. Returns 0 if any of them is not a digit.
+static inline int parse_digits8(const char *p, int len, uint32_t *value) {
+  uint64_t raw;
+  memcpy(&raw, p, 8);
+  uint64_t keep = ~0ULL >> (8 * (8 - len)); // The len low (first) bytes
+  uint64_t want = 0x3030303030303030ULL & keep;
+  uint64_t high = raw & 0xF0F0F0F0F0F0F0F0ULL & keep;
+  uint64_t over = (raw + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL & keep;
+
+  // Right-align the digits (leading zeros) and combine pairs, quads, octets
+  uint64_t v = (raw - 0x3030303030303030ULL) << (8 * (8 - len));
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+       (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+      32;
+  *value = (uint32_t)v;
+  return ((high ^ want) | (over ^ want)) == 0;
+}
+
+// Newlines are found 32 bytes at a time; each line's "L68" is decoded with
+// parse_digits8. The shape checks are combined with '&' rather than '&&' so
+// random L/R directions don't cost a mispredicted branch per line. Lines
+// that don't have the plain shape go to scan_scalar.
+// Returns where the scalar tail has to continue.
+const char *scan_avx2(Scan *sc, const char *begin, const char *end) {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const char *line = begin;
+  const char *block = begin;
+  int prefix = sc->prefix; // Kept in a register across the loop
+
+  // Keep 8 spare bytes so parse_digits8 never reads past the end
+  while (end - block >= 32 + 8) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *)block);
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+    while (mask) {
+      const char *nl = block + __builtin_ctz(mask);
+      mask &= mask - 1;
+
+      int len = nl - line - 1;
+      if (len > 0 && nl[-1] == '\r')
+        len--;
+      char direction = line[0];
+      int fits = (unsigned)(len - 1) < 8;
+      uint32_t distance;
+      int ok = parse_digits8(line + 1, fits ? len : 8, &distance) & fits &
+               ((direction == 'L') | (direction == 'R'));
+      if (ok) {
+        prefix = step(prefix, sc->landed, direction == 'L', distance);
+      } else {
+        sc->prefix = prefix;
+        scan_scalar(sc, line, nl);
+        prefix = sc->prefix;
       }
+      line = nl + 1;
+    }
+    block += 32;
+  }
+  sc->prefix = prefix;
+  return line;
+}
+#endif
+
+// Summarize the rotations in [begin, end). After a rotation the dial is at
+// (s + prefix) % 100, which is 0 exactly when s == (100 - prefix) % 100, so
+// a histogram of the prefixes gives the hits for every start at once.
+void summarize(const char *begin, const char *end, Summary *out) {
+  Scan sc = {0};
+  const char *rest = begin;
+#ifdef __AVX2__
+  rest = scan_avx2(&sc, begin, end);
+#endif
+  scan_scalar(&sc, rest, end);
+
+  for (int s = 0; s < DIAL; s++)
+    out->hits[s] = sc.landed[(DIAL - s) % DIAL];
+  out->offset = sc.prefix;
+}
+
+void *summarize_worker(void *arg) {
+  Chunk *c = arg;
+  summarize(c->begin, c->end, &c->summary);
+  return NULL;
+}
+
+// Map stdin when it is a regular file, otherwise read it all into memory.
+char *read_input(size_t *size, int *mapped) {
+  struct stat st;
+  if (fstat(0, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, 0, 0);
+    if (data != MAP_FAILED) {
+      *size = st.st_size;
+      *mapped = 1;
+      return data;
     }
+  }
 
-    // Check if the dial landed on 0
-    if (current_pos == 0) {
-      zero_hits++;
+  size_t capacity = 1 << 16;
+  char *data = malloc(capacity);
+  *size = 0;
+  *mapped = 0;
+  size_t n;
+  while ((n = fread(data + *size, 1, capacity - *size, stdin)) > 0) {
+    *size += n;
+    if (*size == capacity) {
+      capacity *= 2;
+      data = realloc(data, capacity);
     }
   }
+  return data;
+}
+
+// Dial state: all that is needed to continue after a prefix of the log
+typedef struct {
+  int current_pos;
+  long long zero_hits;
+} Dial;
+
+// Fold the rotations in data into the dial. The data is cut at newlines into
+// one chunk per thread; the chunk summaries are then chained in order.
+void fold_rotations(Dial *dial, const char *data, size_t size) {
+  long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > MAX_THREADS)
+    num_threads = MAX_THREADS;
+  if ((size_t)num_threads > size / MIN_CHUNK_BYTES)
+    num_threads = size / MIN_CHUNK_BYTES > 0 ? size / MIN_CHUNK_BYTES : 1;
+
+  Chunk chunks[MAX_THREADS];
+  const char *cut = data;
+  for (int t = 0; t < num_threads; t++) {
+    chunks[t].begin = cut;
+    if (t == num_threads - 1) {
+      cut = data + size;
+    } else {
+      cut = data + size / num_threads * (t + 1);
+      if (cut < chunks[t].begin)
+        cut = chunks[t].begin;
+      while (cut < data + size && *cut != '\n')
+        cut++;
+    }
+    chunks[t].end = cut;
+  }
+
+  pthread_t threads[MAX_THREADS];
+  for (int t = 1; t < num_threads; t++)
+    pthread_create(&threads[t], NULL, summarize_worker, &chunks[t]);
+  summarize_worker(&chunks[0]);
+  for (int t = 1; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+
+  for (int t = 0; t < num_threads; t++) {
+    dial->zero_hits += chunks[t].summary.hits[dial->current_pos];
+    dial->current_pos = (dial->current_pos + chunks[t].summary.offset) % DIAL;
+  }
+}
+
+// Callbacks for stream mode (see common/checkpoint.h)
+void dial_init(void *state) {
+  Dial *dial = state;
+  dial->current_pos = 50; // The dial starts pointing at 50
+  dial->zero_hits = 0;
+}
+
+void dial_fold(void *state, const char *data, size_t len) {
+  fold_rotations(state, data, len);
+}
+
+void dial_report(const void *state) {
+  const Dial *dial = state;
+  printf("The password is: %lld\n", dial->zero_hits);
+}
+
+// Usage: safe_cracker < input.txt
+//        safe_cracker --stream log.txt [--checkpoint file] [--follow]
+// Stream mode keeps a checkpoint (default: log.txt.day1-part1.ckpt) and only
+// reads what was appended since the last run; --follow keeps watching the
+// log.
+int main(int argc, char **argv) {
+  const char *stream_path = NULL;
+  const char *checkpoint_path = NULL;
+  int follow = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc)
+      stream_path = argv[++i];
+    else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+      checkpoint_path = argv[++i];
+    else if (strcmp(argv[i], "--follow") == 0)
+      follow = 1;
+  }
+
+  Dial dial;
+  dial_init(&dial);
+
+  if (stream_path) {
+    Stream s = {.input_path = stream_path,
+                .checkpoint_path = checkpoint_path,
+                .tag = STREAM_TAG,
+                .state = &dial,
+                .state_size = sizeof(dial),
+                .init = dial_init,
+                .fold = dial_fold,
+                .report = dial_report};
+    return stream_run(&s, follow);
+  }
 
-  printf("The password is: %d\n", zero_hits);
+  PHASE_MARK("parse");
+  size_t size;
+  int mapped;
+  char *data = read_input(&size, &mapped);
+  PHASE_MARK("solve");
+  fold_rotations(&dial, data, size);
+  dial_report(&dial);
 
+  if (mapped)
+    munmap(data, size);
+  else
+    free(data);
   return 0;
-}
\ No newline at end of file
+}
@@ -14,36 +14,110 @@
  * - b is a vector of length n representing the target state of the lights.
  * - x is the solution vector we are solving for.
  * * Algorithm: Gaussian Elimination optimized for minimal Hamming weight.
+ * Rows are stored as bitsets, so elimination works on 64 columns at a time.
+ * Machines are independent and are solved in parallel (link with -pthread).
  */
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-#define MAX_LIGHTS 100
-#define MAX_BUTTONS 100
+#include "../../common/phase.h"
+
+#define WORDS 2                  // 64-bit words per row
+#define ARENA_CHUNK (1 << 20)    // Bytes per arena chunk
+#define MAX_BUTTONS (64 * WORDS) // One bit per button
+#define MAX_GRAY_FREE 26         // Enumerate up to 2^26 solutions directly
+#define MAX_BFS_RANK 24          // Search up to 2^24 pivot patterns
+#define MAX_THREADS 64
+
+typedef uint64_t Row[WORDS]; // One row of A, bit j = coefficient of x_j
+
+/**
+ * Bump Allocator (Arena)
+ * Memory comes from large chunks and is released all at once with
+ * arena_free(), so a machine costs no individual mallocs and its data sits
+ * contiguously in memory.
+ */
+typedef struct Chunk {
+  struct Chunk *next;
+  size_t used, cap;
+  unsigned char data[];
+} Chunk;
+
+typedef struct {
+  Chunk *head; // Current chunk (most recently added)
+} Arena;
+
+/**
+ * Returns size zeroed bytes, 16-byte aligned.
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+  size = (size + 15) & ~(size_t)15;
+  Chunk *c = arena->head;
+  if (!c || c->used + size > c->cap) {
+    size_t cap = size > ARENA_CHUNK ? size : ARENA_CHUNK;
+    c = malloc(sizeof(Chunk) + cap);
+    if (!c) {
+      fprintf(stderr, "Error: Out of memory.\n");
+      exit(1);
+    }
+    c->next = arena->head;
+    c->used = 0;
+    c->cap = cap;
+    arena->head = c;
+  }
+  void *p = c->data + c->used;
+  c->used += size;
+  memset(p, 0, size);
+  return p;
+}
+
+void arena_free(Arena *arena) {
+  while (arena->head) {
+    Chunk *next = arena->head->next;
+    free(arena->head);
+    arena->head = next;
+  }
+}
 
 /**
  * Structure representing the Linear System Ax = b
+ * The arrays are sized to the machine's own light count.
  */
 typedef struct {
-  int n;                          // Number of equations (lights)
-  int m;                          // Number of variables (buttons)
-  int A[MAX_LIGHTS][MAX_BUTTONS]; // The coefficient matrix (mod 2)
-  int b[MAX_LIGHTS];              // The constant vector (target states)
+  int n;          // Number of equations (lights)
+  int m;          // Number of variables (buttons)
+  Row *A;         // The coefficient matrix (mod 2), n rows
+  int *b;         // The constant vector (target states)
+  int *pivot_col; // Pivot column of each row after gauss()
 } System;
 
+static inline int get_bit(const Row r, int j) {
+  return (r[j >> 6] >> (j & 63)) & 1;
+}
+static inline void set_bit(Row r, int j) { r[j >> 6] |= 1ULL << (j & 63); }
+
+static inline int row_weight(const Row r) {
+  int weight = 0;
+  for (int w = 0; w < WORDS; w++)
+    weight += __builtin_popcountll(r[w]);
+  return weight;
+}
+
 /**
  * Parses a single line of input to populate the linear system.
  * Format: "[.##.] (1,2) (3) ..."
  * @param line The raw input string.
  * @param sys Pointer to the System struct to populate.
+ * @param arena Where the system's arrays are allocated.
  */
-void read_line(char *line, System *sys) {
+void read_line(char *line, System *sys, Arena *arena) {
   sys->n = 0;
   sys->m = 0;
-  memset(sys->A, 0, sizeof(sys->A));
-  memset(sys->b, 0, sizeof(sys->b));
 
   // 1. Parse Indicator Lights (The target vector b)
   // '#' denotes On (1), '.' denotes Off (0)
@@ -51,6 +125,16 @@ void read_line(char *line, System *sys) {
   if (!p)
     return;
   p++;
+
+  // Count the lights first, so the arrays can be sized exactly
+  for (char *q = p; *q && *q != ']'; q++) {
+    if (*q == '#' || *q == '.')
+      sys->n++;
+  }
+  sys->A = arena_alloc(arena, sys->n * sizeof(Row));
+  sys->b = arena_alloc(arena, sys->n * sizeof(int));
+  sys->pivot_col = arena_alloc(arena, sys->n * sizeof(int));
+
   int idx = 0;
   while (*p && *p != ']') {
     if (*p == '#')
@@ -64,13 +148,16 @@ void read_line(char *line, System *sys) {
     idx++;
     p++;
   }
-  sys->n = idx;
 
   // 2. Parse Buttons (The columns of matrix A)
   // Format: (0,2,3) means this button affects lights 0, 2, and 3.
   p = strchr(p, '(');
   while (p && *p) {
     if (*p == '(') {
+      if (sys->m >= MAX_BUTTONS) {
+        fprintf(stderr, "Error: MAX_BUTTONS limit reached! Increase WORDS.\n");
+        exit(1);
+      }
       p++;
       char num[10];
       int num_idx = 0;
@@ -83,7 +170,7 @@ void read_line(char *line, System *sys) {
             num[num_idx] = '\0';
             int light = atoi(num);
             if (light < sys->n) {
-              sys->A[light][sys->m] = 1;
+              set_bit(sys->A[light], sys->m);
             }
             num_idx = 0;
           }
@@ -95,7 +182,7 @@ void read_line(char *line, System *sys) {
         num[num_idx] = '\0';
         int light = atoi(num);
         if (light < sys->n) {
-          sys->A[light][sys->m] = 1;
+          set_bit(sys->A[light], sys->m);
         }
       }
       sys->m++; // Move to next button (variable)
@@ -105,24 +192,16 @@ void read_line(char *line, System *sys) {
 }
 
 /**
- * Performs Gaussian Elimination over GF(2) to solve Ax = b.
- * * Since the system might be underdetermined (multiple solutions), this
- * function employs a brute-force search over the "free variables" to find the
- * solution with the minimum Hamming weight (fewest button presses).
- * * @param sys The linear system.
- * @param sol Output array to store the best solution found (0s and 1s).
+ * Performs Gauss-Jordan elimination over GF(2), bringing A to Reduced Row
+ * Echelon Form. Rows are bitsets, so each row operation is WORDS XORs.
+ * * On return, rows 0..rank-1 hold the pivots and sys->pivot_col[i] is the
+ * column of the pivot in row i.
+ * * @param sys The linear system (modified in place).
  * @return The rank of the matrix, or -1 if the system is inconsistent (no
  * solution).
  */
-int gauss(System *sys, int *sol) {
+int gauss(System *sys) {
   int n = sys->n, m = sys->m;
-
-  // 'where' array maps columns (variables) to the row of their pivot.
-  // where[j] = i means the pivot for variable x_j is at row i.
-  int *where = malloc(m * sizeof(int));
-  for (int i = 0; i < m; i++)
-    where[i] = -1;
-
   int row = 0;
 
   // --- Phase 1: Forward Elimination (Row Echelon Form) ---
@@ -130,7 +209,7 @@ int gauss(System *sys, int *sol) {
     // Find a pivot row for the current column
     int sel = -1;
     for (int i = row; i < n; i++) {
-      if (sys->A[i][col]) {
+      if (get_bit(sys->A[i], col)) {
         sel = i;
         break;
       }
@@ -139,26 +218,23 @@ int gauss(System *sys, int *sol) {
       continue; // No pivot in this column, it's a free variable
 
     // Swap the pivot row with the current row
-    for (int j = col; j < m; j++) {
-      int tmp = sys->A[row][j];
-      sys->A[row][j] = sys->A[sel][j];
-      sys->A[sel][j] = tmp;
+    for (int w = 0; w < WORDS; w++) {
+      uint64_t tmp = sys->A[row][w];
+      sys->A[row][w] = sys->A[sel][w];
+      sys->A[sel][w] = tmp;
     }
     int tmp = sys->b[row];
     sys->b[row] = sys->b[sel];
     sys->b[sel] = tmp;
 
-    where[col] = row;
+    sys->pivot_col[row] = col;
 
     // Eliminate this column from all OTHER rows (making it a unit vector
-    // column) This effectively performs Gauss-Jordan to simplify
-    // back-substitution later.
+    // column). XOR is subtraction/addition in GF(2), one word at a time.
     for (int i = 0; i < n; i++) {
-      if (i != row && sys->A[i][col]) {
-        for (int j = col; j < m; j++) {
-          sys->A[i][j] ^=
-              sys->A[row][j]; // XOR is subtraction/addition in GF(2)
-        }
+      if (i != row && get_bit(sys->A[i], col)) {
+        for (int w = 0; w < WORDS; w++)
+          sys->A[i][w] ^= sys->A[row][w];
         sys->b[i] ^= sys->b[row];
       }
     }
@@ -169,133 +245,330 @@ int gauss(System *sys, int *sol) {
   // If a row is all zeros (A[i] == 0) but the target is 1 (b[i] == 1),
   // we have 0 = 1, which is impossible.
   for (int i = row; i < n; i++) {
-    if (sys->b[i]) {
-      free(where);
+    if (sys->b[i])
       return -1; // No solution
-    }
   }
 
-  // --- Phase 3: Construct Minimal Solution ---
+  return row; // Returns rank (number of independent equations)
+}
 
-  // Initial solution: set all variables to 0, then solve for pivots.
-  for (int i = 0; i < m; i++)
-    sol[i] = 0;
-  for (int i = 0; i < m; i++) {
-    if (where[i] != -1) {
-      sol[i] = sys->b[where[i]];
-    }
+/**
+ * Enumerates the whole solution coset x0 + span(basis) in Gray-code order.
+ * * Consecutive Gray codes differ in exactly one bit, so each step flips one
+ * basis vector into the current solution with a single XOR and re-weighs it
+ * with a popcount.
+ * * @return The minimum Hamming weight over all 2^k solutions.
+ */
+int min_weight_gray(Row x0, Row *basis, int k) {
+  Row cur;
+  memcpy(cur, x0, sizeof(Row));
+  int best = row_weight(cur);
+
+  for (uint64_t g = 1; g < (1ULL << k); g++) {
+    int flip = __builtin_ctzll(g); // Bit that changes between g-1 and g
+    for (int w = 0; w < WORDS; w++)
+      cur[w] ^= basis[flip][w];
+    int weight = row_weight(cur);
+    if (weight < best)
+      best = weight;
   }
+  return best;
+}
 
-  // Identify Free Variables (columns without pivots).
-  // These variables can be arbitrarily set to 0 or 1.
-  // Changing a free variable requires adjusting dependent variables (pivots) to
-  // keep equations valid.
-  int free_vars = 0;
-  int free_idx[MAX_BUTTONS];
-  for (int i = 0; i < m; i++) {
-    if (where[i] == -1) {
-      free_idx[free_vars++] = i;
-    }
+/**
+ * Minimum-weight search over the pivot rows instead of the free variables.
+ * * Choosing free variable f costs 1 press and flips the pivot pattern by
+ * column f of the RREF. Each pivot variable that ends up set costs 1 press as
+ * well, which is the same as flipping its own bit. So the answer is the
+ * shortest path from 0 to the pivot pattern of the base solution in the
+ * 2^rank hypercube, using the free columns and the unit vectors as edges.
+ * * Breadth First Search gives it exactly in O(2^rank * (k + rank)), which is
+ * independent of the number of free variables.
+ * @return The minimum Hamming weight, or -1 if rank is too large.
+ */
+int min_weight_bfs(System *sys, int rank, int *free_idx, int k) {
+  if (rank > MAX_BFS_RANK)
+    return -1;
+
+  // Pivot pattern of the base solution and the free columns, packed as
+  // rank-bit integers
+  uint32_t target = 0;
+  for (int i = 0; i < rank; i++)
+    if (sys->b[i])
+      target |= 1u << i;
+
+  int num_gens = k + rank;
+  uint32_t *gens = malloc(num_gens * sizeof(uint32_t));
+  for (int f = 0; f < k; f++) {
+    gens[f] = 0;
+    for (int i = 0; i < rank; i++)
+      if (get_bit(sys->A[i], free_idx[f]))
+        gens[f] |= 1u << i;
   }
-
-  // Calculate weight of the base solution
-  int min_weight = 0;
-  for (int i = 0; i < m; i++)
-    min_weight += sol[i];
-
-  int best_sol[MAX_BUTTONS];
-  memcpy(best_sol, sol, m * sizeof(int));
-
-  // Optimization: Brute force the Free Variables to minimize total presses.
-  // If there are k free variables, there are 2^k valid solutions (the Null
-  // Space). We expect 'free_vars' to be small (<= 15) for this optimization to
-  // run quickly.
-  if (free_vars <= 15) {
-    for (int mask = 0; mask < (1 << free_vars); mask++) {
-      int temp_sol[MAX_BUTTONS];
-      memcpy(temp_sol, sol, m * sizeof(int));
-
-      // 1. Set free variables based on the current mask
-      for (int f = 0; f < free_vars; f++) {
-        if (mask & (1 << f)) {
-          temp_sol[free_idx[f]] = 1;
-        } else {
-          temp_sol[free_idx[f]] = 0;
-        }
+  for (int i = 0; i < rank; i++)
+    gens[k + i] = 1u << i;
+
+  uint32_t size = 1u << rank;
+  unsigned char *dist = malloc(size);
+  memset(dist, 0xFF, size); // 0xFF = not visited yet
+  uint32_t *queue = malloc(size * sizeof(uint32_t));
+  uint32_t head = 0, tail = 0;
+
+  dist[0] = 0;
+  queue[tail++] = 0;
+  while (head < tail && dist[target] == 0xFF) {
+    uint32_t s = queue[head++];
+    for (int g = 0; g < num_gens; g++) {
+      uint32_t t = s ^ gens[g];
+      if (dist[t] == 0xFF) {
+        dist[t] = dist[s] + 1;
+        queue[tail++] = t;
       }
+    }
+  }
 
-      // 2. Re-calculate dependent variables (pivots) based on free variable
-      // choices
-      for (int i = 0; i < m; i++) {
-        if (where[i] != -1) { // If 'i' is a pivot variable
-          int val = sys->b[where[i]];
-          // The value of pivot i depends on the target b and the values of
-          // other cols in this row
-          for (int j = 0; j < m; j++) {
-            if (j != i && sys->A[where[i]][j]) {
-              val ^= temp_sol[j];
-            }
-          }
-          temp_sol[i] = val;
-        }
-      }
+  // The unit vectors span the whole space, so the target is always reached
+  int best = dist[target];
+  free(gens);
+  free(dist);
+  free(queue);
+  return best;
+}
 
-      // 3. Check if this combination yields a lower total weight
-      int weight = 0;
-      for (int i = 0; i < m; i++)
-        weight += temp_sol[i];
+/**
+ * Finds the solution of the reduced system with the minimum Hamming weight
+ * (fewest button presses).
+ * * The system might be underdetermined: every free variable (column without a
+ * pivot) can be 0 or 1, and each choice flips a fixed set of pivot variables.
+ * * @param sys The system in RREF (after gauss()).
+ * @param rank The rank returned by gauss().
+ * @return The minimum number of presses.
+ */
+int min_presses(System *sys, int rank) {
+  int m = sys->m;
+
+  // Initial solution: set all free variables to 0, then pivots equal b.
+  Row x0 = {0};
+  int is_pivot[MAX_BUTTONS] = {0};
+  for (int i = 0; i < rank; i++) {
+    is_pivot[sys->pivot_col[i]] = 1;
+    if (sys->b[i])
+      set_bit(x0, sys->pivot_col[i]);
+  }
 
-      if (weight < min_weight) {
-        min_weight = weight;
-        memcpy(best_sol, temp_sol, m * sizeof(int));
-      }
+  // Null Space basis: one vector per free variable f. Setting x_f = 1
+  // requires flipping every pivot whose row has a 1 in column f.
+  int k = 0;
+  int free_idx[MAX_BUTTONS];
+  Row basis[MAX_BUTTONS];
+  for (int f = 0; f < m; f++) {
+    if (is_pivot[f])
+      continue;
+    memset(basis[k], 0, sizeof(Row));
+    set_bit(basis[k], f);
+    for (int i = 0; i < rank; i++) {
+      if (get_bit(sys->A[i], f))
+        set_bit(basis[k], sys->pivot_col[i]);
     }
+    free_idx[k++] = f;
   }
 
-  memcpy(sol, best_sol, m * sizeof(int));
-  free(where);
-  return row; // Returns rank (number of independent equations)
+  // Pick whichever side of the system is smaller to enumerate: the 2^k
+  // solutions directly, or the 2^rank pivot patterns.
+  if (k <= MAX_GRAY_FREE && k <= rank)
+    return min_weight_gray(x0, basis, k);
+
+  int best = min_weight_bfs(sys, rank, free_idx, k);
+  if (best >= 0)
+    return best;
+
+  if (k <= MAX_GRAY_FREE)
+    return min_weight_gray(x0, basis, k);
+
+  // Both sides too large: the base solution is valid but may not be minimal
+  fprintf(stderr,
+          "Warning: %d free variables and rank %d, answer may not be "
+          "minimal.\n",
+          k, rank);
+  return row_weight(x0);
 }
 
 /**
- * Wrapper to solve the system and sum the result.
+ * Wrapper to solve the system and return the minimum number of presses.
  */
 int solve_system(System *sys) {
-  int sol[MAX_BUTTONS];
-  int rank = gauss(sys, sol);
+  int rank;
+  PHASE("gauss") rank = gauss(sys);
 
   if (rank == -1)
     return -1; // No solution found
 
-  int presses = 0;
-  for (int i = 0; i < sys->m; i++) {
-    presses += sol[i];
+  return min_presses(sys, rank);
+}
+
+/* ========================================================================== */
+/*  Parallel Machine Solver                                                   */
+/* ========================================================================== */
+
+/**
+ * One machine of the input, solved independently of all others.
+ */
+typedef struct {
+  System sys;
+  int expected_free; // Scheduling estimate: buttons beyond the light count
+  int presses;       // Result (-1 if no solution)
+} Job;
+
+/**
+ * Per-thread work queue. The owner takes jobs from the front (hardest
+ * first), idle threads steal from the back.
+ */
+typedef struct {
+  Job **items;
+  int head, tail;
+  pthread_mutex_t lock;
+} Deque;
+
+typedef struct {
+  Deque *deques;
+  int num_threads;
+} Pool;
+
+typedef struct {
+  Pool *pool;
+  int id;
+} Worker;
+
+/**
+ * Comparison function for qsort: most expected free variables first.
+ */
+int compare_jobs(const void *a, const void *b) {
+  const Job *j1 = *(Job *const *)a;
+  const Job *j2 = *(Job *const *)b;
+  return j2->expected_free - j1->expected_free;
+}
+
+/**
+ * Returns the next job for thread id: from its own queue first, otherwise
+ * stolen from another thread. Returns NULL once every queue is empty.
+ */
+Job *take_job(Pool *pool, int id) {
+  for (int k = 0; k < pool->num_threads; k++) {
+    Deque *dq = &pool->deques[(id + k) % pool->num_threads];
+    Job *job = NULL;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail)
+      job = (k == 0) ? dq->items[dq->head++] : dq->items[--dq->tail];
+    pthread_mutex_unlock(&dq->lock);
+    if (job)
+      return job;
+  }
+  return NULL;
+}
+
+void *solve_worker(void *arg) {
+  Worker *w = (Worker *)arg;
+  Job *job;
+  while ((job = take_job(w->pool, w->id)) != NULL)
+    job->presses = solve_system(&job->sys);
+  return NULL;
+}
+
+/**
+ * Solves every job on a work-stealing thread pool. Jobs are sorted by
+ * expected difficulty and dealt round-robin, so each thread starts with its
+ * share of the hard machines; results stay in input order inside jobs[].
+ */
+void solve_all(Job *jobs, int count) {
+  if (count == 0)
+    return;
+
+  long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > MAX_THREADS)
+    num_threads = MAX_THREADS;
+  if (num_threads > count)
+    num_threads = count;
+
+  Job **order = malloc(count * sizeof(Job *));
+  for (int i = 0; i < count; i++)
+    order[i] = &jobs[i];
+  qsort(order, count, sizeof(Job *), compare_jobs);
+
+  Pool pool;
+  pool.num_threads = num_threads;
+  pool.deques = malloc(num_threads * sizeof(Deque));
+  for (int t = 0; t < num_threads; t++) {
+    pool.deques[t].items = malloc((count / num_threads + 1) * sizeof(Job *));
+    pool.deques[t].head = 0;
+    pool.deques[t].tail = 0;
+    pthread_mutex_init(&pool.deques[t].lock, NULL);
+  }
+  for (int i = 0; i < count; i++) {
+    Deque *dq = &pool.deques[i % num_threads];
+    dq->items[dq->tail++] = order[i];
+  }
+
+  pthread_t threads[MAX_THREADS];
+  Worker workers[MAX_THREADS];
+  for (int t = 0; t < num_threads; t++) {
+    workers[t].pool = &pool;
+    workers[t].id = t;
+    pthread_create(&threads[t], NULL, solve_worker, &workers[t]);
   }
-  return presses;
+  for (int t = 0; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+
+  for (int t = 0; t < num_threads; t++) {
+    pthread_mutex_destroy(&pool.deques[t].lock);
+    free(pool.deques[t].items);
+  }
+  free(pool.deques);
+  free(order);
 }
 
 int main() {
-  char line[1000];
+  char *line = NULL;
+  size_t line_cap = 0;
   int total_presses = 0;
 
-  // Read input line by line until EOF
-  while (fgets(line, sizeof(line), stdin)) {
+  PHASE_MARK("parse");
+  // Read every machine first, then solve them all in parallel. The parsed
+  // systems all live in one arena, sized to each machine.
+  int capacity = 64, count = 0;
+  Job *jobs = malloc(capacity * sizeof(Job));
+  Arena machines = {NULL};
+
+  // Read input line by line until EOF (getline: no limit on line length)
+  while (getline(&line, &line_cap, stdin) != -1) {
     // Skip short or empty lines
     if (strlen(line) < 3)
       continue;
 
-    System sys;
-    read_line(line, &sys);
+    if (count >= capacity) {
+      capacity *= 2;
+      jobs = realloc(jobs, capacity * sizeof(Job));
+    }
+    Job *job = &jobs[count++];
+    read_line(line, &job->sys, &machines);
+    job->expected_free = job->sys.m - job->sys.n;
+    job->presses = -1;
+  }
 
-    // Solve for the current machine
-    int presses = solve_system(&sys);
+  PHASE_MARK("solve");
+  solve_all(jobs, count);
 
+  for (int i = 0; i < count; i++) {
     // Only add to total if a solution exists (presses >= 0)
-    if (presses >= 0) {
-      total_presses += presses;
+    if (jobs[i].presses >= 0) {
+      total_presses += jobs[i].presses;
     }
   }
 
   printf("Total Minimum Presses: %d\n", total_presses);
+  arena_free(&machines);
+  free(jobs);
+  free(line);
   return 0;
-}
\ No newline at end of file
+}
@@ -12,154 +12,407 @@
  * - b is the target vector.
  * - x is the vector of press counts.
  * * Algorithm:
- * 1. Gaussian Elimination: Converts the matrix A to Reduced Row Echelon Form
- * (RREF).
+ * 1. Fraction-free Gaussian Elimination: Converts the matrix A to an integer
+ * Reduced Row Echelon Form, where every row keeps its own pivot coefficient
+ * (denominator) instead of being divided down to 1.
  * 2. Variable Classification: Identifies 'Pivot' variables (dependent) and
  * 'Free' variables (independent).
- * 3. Recursive Search: Since the system is underdetermined, we iterate through
- * possible values for the 'Free' variables. For each guess, we calculate the
+ * 3. Branch-and-Bound Search: Since the system is underdetermined, we iterate
+ * through possible values for the 'Free' variables, each bounded by the
+ * smallest target its button touches. The pivots are the basic variables of
+ * the LP relaxation's optimum, so the total reads base + sum(cost_f * x_f)
+ * with every cost_f >= 0 (reduced costs): each free variable is walked up
+ * from 0 and its loop ends at the first value this bound rejects. Interval
+ * propagation on the pivot rows cuts off the rest. Free variables that move
+ * the pivots the most are fixed first. For each full guess, we calculate the
  * required values of the 'Pivot' variables.
  * 4. Validation: A solution is valid only if all calculated Pivot variables are
- * non-negative integers.
+ * non-negative integers, i.e. each row's numerator is non-negative and exactly
+ * divisible by its denominator.
+ * * By default the in-tree ILP engine (dense two-phase simplex +
+ * branch-and-bound, in floating point) also runs first, with small limits, to
+ * find a good solution; the solution is checked exactly and then handed to
+ * the search as the total to beat, which proves it minimal or improves on it.
+ * Only the search decides the answer, so rounding in the simplex can cost
+ * time but never correctness. The search stops after SEARCH_MAX_NODES nodes;
+ * a machine that needs more (or whose integers outgrow 64 bits) is reported
+ * as unproven and the exit status is 1. Run with --search to skip the
+ * branch-and-bound (the search still uses the LP optimum), or with --check to
+ * compare the ILP alone against the search.
+ * * Machines are independent and are solved in parallel (link with -pthread).
  */
 
+#include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-#define MAX_VARS 100
-#define EPSILON 1e-9
+#include "../../common/phase.h"
+
+#define ARENA_CHUNK (1 << 20) // Bytes per arena chunk
+#define LP_EPS 1e-9         // Zero tolerance inside the simplex
+#define INT_EPS 1e-6        // Distance from an integer that counts as integral
+#define MAX_PIVOTS 100000   // Pivots per simplex run before giving up
+#define MAX_NODES 2000      // Branch-and-bound nodes per machine
+#define SEARCH_MAX_NODES 50000000LL // Search nodes per machine
+#define MAX_DEPTH 64        // Branching depth (each level keeps a tableau)
+#define DEGENERATE_RUN 50   // Stalled dual pivots before Bland's rule
+#define MAX_THREADS 64
+
+/**
+ * Bump Allocator (Arena)
+ * Memory comes from large chunks and is released all at once with
+ * arena_reset() or arena_free(), so a machine costs no individual mallocs and
+ * its data sits contiguously in memory.
+ */
+typedef struct Chunk {
+  struct Chunk *next;
+  size_t used, cap;
+  unsigned char data[];
+} Chunk;
+
+typedef struct {
+  Chunk *head; // Current chunk (most recently added)
+} Arena;
+
+/**
+ * Returns size zeroed bytes, 16-byte aligned.
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+  size = (size + 15) & ~(size_t)15;
+  Chunk *c = arena->head;
+  if (!c || c->used + size > c->cap) {
+    size_t cap = size > ARENA_CHUNK ? size : ARENA_CHUNK;
+    c = malloc(sizeof(Chunk) + cap);
+    if (!c) {
+      fprintf(stderr, "Error: Out of memory.\n");
+      exit(1);
+    }
+    c->next = arena->head;
+    c->used = 0;
+    c->cap = cap;
+    arena->head = c;
+  }
+  void *p = c->data + c->used;
+  c->used += size;
+  memset(p, 0, size);
+  return p;
+}
+
+/**
+ * Releases everything but the current chunk, which is kept for reuse.
+ */
+void arena_reset(Arena *arena) {
+  Chunk *c = arena->head;
+  if (!c)
+    return;
+  while (c->next) {
+    Chunk *next = c->next->next;
+    free(c->next);
+    c->next = next;
+  }
+  c->used = 0;
+}
+
+void arena_free(Arena *arena) {
+  while (arena->head) {
+    Chunk *next = arena->head->next;
+    free(arena->head);
+    arena->head = next;
+  }
+}
 
 /**
  * System Structure
  * Represents the linear equation system Ax = b.
+ * After elimination, row r (r < rank) reads:
+ * A[r][pivot_col[r]] * x_pivot + sum(A[r][f] * x_f) = b[r]
+ * with A[r][pivot_col[r]] > 0 acting as the row's denominator.
  */
 typedef struct {
-  int rows;                     // Number of equations (counters)
-  int cols;                     // Number of variables (buttons)
-  double A[MAX_VARS][MAX_VARS]; // Coefficient Matrix
-  double b[MAX_VARS];           // Target Vector
-  int pivot_col[MAX_VARS];      // Index of the pivot column for each row (-1 if
-                                // none)
-  int free_vars[MAX_VARS];      // List of column indices corresponding to free
-                                // variables
-  int num_free;                 // Count of free variables
+  int rows;               // Number of equations (counters)
+  int cols;               // Number of variables (buttons)
+  long long **A;          // Coefficient Matrix (rows x cols)
+  long long *b;           // Target Vector (rows)
+  int rank;               // Number of rows with a pivot
+  int *pivot_col;         // Index of the pivot column for each row (-1 if
+                          // none)
+  int *free_vars;         // List of column indices corresponding to free
+                          // variables
+  int num_free;           // Count of free variables
+  long long *upper_bound; // Max presses for each button (cols)
+  long long min_presses;  // Minimum sum of presses found across all valid
+                          // solutions (-1 if none)
+  double *cost;           // Total presses per unit of each free variable,
+                          // pivots included (the objective over free vars)
+  double base;            // Total presses with every free variable at 0
+  double *cost_tail;      // sum(min(0, cost) * upper_bound) over
+                          // free_vars[k..], for k = 0..num_free
+  double slack;           // Rounding allowance on the cost bound
+  long long nodes;        // Search nodes visited
+  bool capped;            // The search hit SEARCH_MAX_NODES: min_presses is
+                          // only the best found
 } System;
 
-// Tracks the global minimum sum of presses found across all valid solutions for
-// a machine
-long long global_min_presses = -1;
+/**
+ * Allocates the arrays of a System sized to its rows x cols from the arena.
+ * The matrix is one contiguous block; A[i] points at row i, so rows can be
+ * swapped by swapping pointers.
+ */
+void alloc_system(System *sys, Arena *arena) {
+  int rows = sys->rows, cols = sys->cols;
+  long long *cells =
+      arena_alloc(arena, (size_t)rows * cols * sizeof(long long));
+  sys->A = arena_alloc(arena, rows * sizeof(long long *));
+  for (int i = 0; i < rows; i++)
+    sys->A[i] = cells + (size_t)i * cols;
+  sys->b = arena_alloc(arena, rows * sizeof(long long));
+  sys->pivot_col = arena_alloc(arena, rows * sizeof(int));
+  sys->free_vars = arena_alloc(arena, cols * sizeof(int));
+  sys->upper_bound = arena_alloc(arena, cols * sizeof(long long));
+  sys->rank = 0;
+  sys->num_free = 0;
+  sys->min_presses = -1;
+}
+
+/**
+ * Deep copy of a parsed (not yet reduced) System into the arena.
+ */
+void copy_system(System *dst, const System *src, Arena *arena) {
+  dst->rows = src->rows;
+  dst->cols = src->cols;
+  alloc_system(dst, arena);
+  for (int i = 0; i < src->rows; i++)
+    memcpy(dst->A[i], src->A[i], src->cols * sizeof(long long));
+  memcpy(dst->b, src->b, src->rows * sizeof(long long));
+}
+
+/**
+ * Helper: Greatest common divisor of two non-negative values.
+ */
+__int128 gcd(__int128 a, __int128 b) {
+  while (b) {
+    __int128 t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
 
 /**
- * Helper: Checks if a floating point value is effectively an integer.
- * Used because Gaussian elimination introduces floating point division.
+ * Helper: Divides a row held in 128 bits (cols coefficients, then b) by the
+ * gcd of its entries, so the integers stay as small as possible between
+ * elimination steps. Only the reduced row has to fit back in 64 bits.
+ * * @return false if some reduced entry still doesn't fit in a long long.
  */
-bool is_int(double v) { return fabs(v - round(v)) < EPSILON; }
+bool reduce_row(__int128 *row, int len) {
+  __int128 g = 0;
+  for (int j = 0; j < len && g != 1; j++)
+    g = gcd(g, row[j] < 0 ? -row[j] : row[j]);
+  for (int j = 0; j < len; j++) {
+    if (g > 1)
+      row[j] /= g;
+    if (row[j] > LLONG_MAX || row[j] < -LLONG_MAX)
+      return false;
+  }
+  return true;
+}
 
 /**
- * Recursive Search for Free Variables
- * * @param sys The system struct containing RREF matrix.
+ * Helper: Checks that the search arithmetic can't overflow. Every quantity it
+ * computes for row r (partial numerators, interval ends, d * upper_bound) is
+ * bounded by |b[r]| + sum(|A[r][j]| * upper_bound[j]) over all columns.
+ */
+bool search_fits(System *sys) {
+  for (int r = 0; r < sys->rank; r++) {
+    __int128 total = sys->b[r] < 0 ? -(__int128)sys->b[r] : sys->b[r];
+    for (int j = 0; j < sys->cols; j++) {
+      __int128 a = sys->A[r][j] < 0 ? -(__int128)sys->A[r][j] : sys->A[r][j];
+      total += a * sys->upper_bound[j];
+      if (total > LLONG_MAX)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Branch-and-bound pruning test for a partial assignment.
+ * * Free variables free_vars[0..free_idx-1] are fixed; the rest can still take
+ * any value in [0, upper_bound]. For each pivot row this gives an interval
+ * [lo, hi] for the numerator d * x_pivot, and:
+ * - hi < 0 means the pivot is forced negative,
+ * - lo > d * upper_bound[pivot] means the pivot is forced too large,
+ * - ceil(lo / d) is a lower bound on the pivot's presses, which together
+ * with the fixed free variables must stay below min_presses.
+ * * @return false if no completion of this assignment can improve the answer.
+ */
+bool can_improve(System *sys, int free_idx, long long *solution,
+                 long long partial_sum) {
+  long long lower_total = partial_sum;
+
+  for (int r = 0; r < sys->rank; r++) {
+    long long lo = sys->b[r], hi = sys->b[r];
+
+    for (int j = 0; j < sys->num_free; j++) {
+      int f = sys->free_vars[j];
+      if (j < free_idx) {
+        lo -= sys->A[r][f] * solution[f];
+        hi -= sys->A[r][f] * solution[f];
+      } else if (sys->A[r][f] > 0) {
+        lo -= sys->A[r][f] * sys->upper_bound[f];
+      } else {
+        hi -= sys->A[r][f] * sys->upper_bound[f];
+      }
+    }
+
+    int p = sys->pivot_col[r];
+    long long d = sys->A[r][p];
+    if (hi < 0 || lo > d * sys->upper_bound[p])
+      return false;
+    if (lo > 0)
+      lower_total += (lo + d - 1) / d;
+  }
+
+  return sys->min_presses == -1 || lower_total < sys->min_presses;
+}
+
+/**
+ * Cost bound: with free_vars[0..free_idx-1] fixed (contributing
+ * partial_cost), the total is at least base + partial_cost + cost_tail.
+ * The costs are rationals held in doubles, so the bound is lowered by slack
+ * before it is compared against the best (integer) total.
+ * * @return true if no completion can beat min_presses.
+ */
+bool cost_prunes(System *sys, int free_idx, double partial_cost) {
+  if (sys->min_presses == -1)
+    return false;
+  double bound = sys->base + partial_cost + sys->cost_tail[free_idx];
+  return bound - sys->slack > (double)(sys->min_presses - 1);
+}
+
+/**
+ * Recursive Branch-and-Bound Search for Free Variables
+ * * @param sys The system struct containing the integer RREF matrix.
  * @param free_idx The index in the free_vars array we are currently guessing.
  * @param solution The array storing current values for all variables (x).
+ * @param partial_sum Sum of the free variables assigned so far.
+ * @param partial_cost sum(cost_f * x_f) over the free variables assigned.
  */
-void search(System *sys, int free_idx, double *solution) {
+void search(System *sys, int free_idx, long long *solution,
+            long long partial_sum, double partial_cost) {
+
+  if (++sys->nodes > SEARCH_MAX_NODES) {
+    sys->capped = true;
+    return;
+  }
+
+  // Bound: drop this branch if it cannot beat the best solution found so far
+  if (!can_improve(sys, free_idx, solution, partial_sum))
+    return;
 
   // Base Case: All free variables have been assigned a value.
   // Now we compute the dependent (Pivot) variables to see if this configuration
   // works.
   if (free_idx == sys->num_free) {
-    double current_sol[MAX_VARS];
-    // Copy current guesses for free variables
-    for (int i = 0; i < sys->cols; i++)
-      current_sol[i] = solution[i];
-
-    long long current_sum = 0;
-    bool valid = true;
+    long long current_sum = partial_sum;
 
     // Calculate Pivot Variables using back-substitution logic.
-    // In RREF, the equation for row r is: x_{pivot} + sum(A[r][f] * x_f) = b[r]
-    // Therefore: x_{pivot} = b[r] - sum(A[r][f] * x_f)
-    for (int r = 0; r < sys->rows; r++) {
-      int p = sys->pivot_col[r];
-
-      // If this row has no pivot (all zeros), check consistency (0 = b[r])
-      if (p == -1) {
-        if (fabs(sys->b[r]) > EPSILON) {
-          valid = false;
-          break;
-        }
-        continue;
-      }
-
-      double val = sys->b[r];
+    // In integer RREF, the equation for row r is:
+    // d * x_{pivot} + sum(A[r][f] * x_f) = b[r]
+    // Therefore: x_{pivot} = (b[r] - sum(A[r][f] * x_f)) / d
+    for (int r = 0; r < sys->rank; r++) {
+      long long num = sys->b[r];
 
       // Subtract contributions from free variables
       for (int j = 0; j < sys->num_free; j++) {
         int f = sys->free_vars[j];
-        if (fabs(sys->A[r][f]) > EPSILON) {
-          val -= sys->A[r][f] * solution[f];
-        }
+        num -= sys->A[r][f] * solution[f];
       }
 
       // Constraint Check: Pivot must be a non-negative Integer
-      if (val < -EPSILON || !is_int(val)) {
-        valid = false;
-        break;
-      }
-      current_sol[p] = round(val);
+      long long d = sys->A[r][sys->pivot_col[r]];
+      if (num < 0 || num % d != 0)
+        return;
+      current_sum += num / d;
     }
 
-    // Final Summation and Update Global Min
-    if (valid) {
-      for (int i = 0; i < sys->cols; i++) {
-        if (current_sol[i] < 0) {
-          valid = false;
-          break;
-        } // Safety check
-        current_sum += (long long)current_sol[i];
-      }
-    }
-
-    if (valid) {
-      if (global_min_presses == -1 || current_sum < global_min_presses) {
-        global_min_presses = current_sum;
-      }
+    // Update Global Min
+    if (sys->min_presses == -1 || current_sum < sys->min_presses) {
+      sys->min_presses = current_sum;
     }
     return;
   }
 
-  // Recursive Step: Iterate possible values for the current free variable.
+  // Branch: Iterate possible values for the current free variable.
+  // The range is exact: a button can't be pressed more times than the
+  // smallest target among the counters it touches. Values are walked in the
+  // direction that raises the cost bound (up from 0 for a non-negative
+  // cost), so the first value it rejects ends the loop.
   int f_var = sys->free_vars[free_idx];
-
-  // Search Range: 0 to 200.
-  // Free variables represent degrees of freedom in the system.
-  // In these puzzles, the required adjustment via free variables is typically
-  // small.
-  for (int val = 0; val <= 200; val++) {
-    solution[f_var] = (double)val;
-
-    // Optimization: We could add pruning here if the partial sum already
-    // exceeds global_min_presses, but given the small depth (num_free is
-    // usually low), raw recursion is fast enough.
-
-    search(sys, free_idx + 1, solution);
+  long long ub = sys->upper_bound[f_var];
+  double c = sys->cost[f_var];
+  for (long long k = 0; k <= ub; k++) {
+    long long val = c >= 0 ? k : ub - k;
+    double cost = partial_cost + c * (double)val;
+    if (cost_prunes(sys, free_idx + 1, cost))
+      break;
+    solution[f_var] = val;
+    search(sys, free_idx + 1, solution, partial_sum + val, cost);
   }
   solution[f_var] = 0; // Reset for cleanliness
 }
 
 /**
- * Solves the linear system using Gaussian Elimination + Search.
+ * Solves the linear system using fraction-free Gaussian Elimination + Search.
+ * Temporary arrays come from the scratch arena.
+ * * @param columns Order in which columns are tried as pivots (NULL: left to
+ * right). Putting the LP optimum's basic columns first makes the free
+ * variables its non-basic ones, whose costs are the non-negative reduced
+ * costs.
+ * @param incumbent Total of a solution already checked exactly (-1 if
+ * none): the search only looks for better ones, and min_presses stays at it
+ * if there are none.
+ * @return false if the exact integers outgrow 64 bits (min_presses is then
+ * meaningless and the machine needs another engine).
  */
-void solve_system(System *sys) {
-  // --- Phase 1: Gaussian Elimination (Forward) ---
+bool solve_system(System *sys, const int *columns, long long incumbent,
+                  Arena *scratch) {
+  sys->min_presses = incumbent;
+  sys->nodes = 0;
+  sys->capped = false;
+
+  // --- Phase 0: Per-button Upper Bounds ---
+  // Every press adds +1 to each counter the button touches, so a button can't
+  // be pressed more times than the smallest of those targets.
+  for (int j = 0; j < sys->cols; j++) {
+    sys->upper_bound[j] = -1;
+    for (int i = 0; i < sys->rows; i++) {
+      if (sys->A[i][j] != 0 &&
+          (sys->upper_bound[j] == -1 || sys->b[i] < sys->upper_bound[j]))
+        sys->upper_bound[j] = sys->b[i];
+    }
+    if (sys->upper_bound[j] == -1)
+      sys->upper_bound[j] = 0; // Button touches nothing: pressing it is waste
+  }
+
+  // --- Phase 1: Fraction-free Gauss-Jordan Elimination ---
+  // Row operations are row_i = d * row_i - factor * row_pivot, computed in
+  // 128 bits and gcd-reduced there before the row is stored back, so every
+  // entry stays an exact integer and no division ever rounds.
   int pivot_row = 0;
-  for (int col = 0; col < sys->cols && pivot_row < sys->rows; col++) {
+  int *is_pivot = arena_alloc(scratch, sys->cols * sizeof(int));
+  __int128 *wide = arena_alloc(scratch, (sys->cols + 1) * sizeof(__int128));
+  for (int k = 0; k < sys->cols && pivot_row < sys->rows; k++) {
+    int col = columns ? columns[k] : k;
     // Find a pivot row for this column
     int sel = -1;
     for (int i = pivot_row; i < sys->rows; i++) {
-      if (fabs(sys->A[i][col]) > EPSILON) {
+      if (sys->A[i][col] != 0) {
         sel = i;
         break;
       }
@@ -168,155 +421,860 @@ void solve_system(System *sys) {
       continue; // Column is independent (Free Variable)
 
     // Swap pivot row to current position
-    for (int j = col; j < sys->cols; j++) {
-      double tmp = sys->A[pivot_row][j];
-      sys->A[pivot_row][j] = sys->A[sel][j];
-      sys->A[sel][j] = tmp;
-    }
-    double tmp_b = sys->b[pivot_row];
+    long long *tmp = sys->A[pivot_row];
+    sys->A[pivot_row] = sys->A[sel];
+    sys->A[sel] = tmp;
+    long long tmp_b = sys->b[pivot_row];
     sys->b[pivot_row] = sys->b[sel];
     sys->b[sel] = tmp_b;
 
-    // Normalize row (make pivot element 1.0)
-    double div = sys->A[pivot_row][col];
-    for (int j = col; j < sys->cols; j++)
-      sys->A[pivot_row][j] /= div;
-    sys->b[pivot_row] /= div;
+    // Keep the denominator positive
+    if (sys->A[pivot_row][col] < 0) {
+      for (int j = 0; j < sys->cols; j++)
+        sys->A[pivot_row][j] = -sys->A[pivot_row][j];
+      sys->b[pivot_row] = -sys->b[pivot_row];
+    }
 
     // Eliminate column entries in other rows
+    long long d = sys->A[pivot_row][col];
     for (int i = 0; i < sys->rows; i++) {
-      if (i != pivot_row && fabs(sys->A[i][col]) > EPSILON) {
-        double factor = sys->A[i][col];
-        for (int j = col; j < sys->cols; j++)
-          sys->A[i][j] -= factor * sys->A[pivot_row][j];
-        sys->b[i] -= factor * sys->b[pivot_row];
+      if (i != pivot_row && sys->A[i][col] != 0) {
+        long long factor = sys->A[i][col];
+        for (int j = 0; j < sys->cols; j++)
+          wide[j] = (__int128)d * sys->A[i][j] -
+                    (__int128)factor * sys->A[pivot_row][j];
+        wide[sys->cols] =
+            (__int128)d * sys->b[i] - (__int128)factor * sys->b[pivot_row];
+        if (!reduce_row(wide, sys->cols + 1))
+          return false;
+        for (int j = 0; j < sys->cols; j++)
+          sys->A[i][j] = (long long)wide[j];
+        sys->b[i] = (long long)wide[sys->cols];
       }
     }
     sys->pivot_col[pivot_row] = col;
+    is_pivot[col] = 1;
     pivot_row++;
   }
+  sys->rank = pivot_row;
+
+  // Rows without a pivot read 0 = b[r]; any non-zero target means the machine
+  // has no solution at all.
+  for (int r = sys->rank; r < sys->rows; r++) {
+    sys->pivot_col[r] = -1;
+    if (sys->b[r] != 0)
+      return true;
+  }
+  if (!search_fits(sys))
+    return false;
 
   // --- Phase 2: Identify Free Variables ---
+  // Any column that isn't a pivot is a Free Variable
   sys->num_free = 0;
-  int is_pivot[MAX_VARS] = {0};
+  for (int j = 0; j < sys->cols; j++) {
+    if (!is_pivot[j]) {
+      sys->free_vars[sys->num_free++] = j;
+    }
+  }
 
-  // Map rows to their pivot columns
-  for (int i = 0; i < sys->rows; i++) {
-    if (fabs(sys->b[i]) < EPSILON)
-      sys->b[i] = 0.0; // Clean small errors
+  // --- Phase 3: Objective over the Free Variables ---
+  // total = sum(x_f) + sum_r (b[r] - sum(A[r][f] * x_f)) / d_r, so
+  // base = sum_r b[r] / d_r and cost_f = 1 - sum_r A[r][f] / d_r. Each value
+  // is a sum of at most rows + 1 rounded terms; 1e-9 of the magnitudes
+  // involved bounds their error by orders of magnitude.
+  sys->cost = arena_alloc(scratch, sys->cols * sizeof(double));
+  sys->cost_tail = arena_alloc(scratch, (sys->num_free + 1) * sizeof(double));
+  double *span = arena_alloc(scratch, sys->cols * sizeof(double));
+  double magnitude = 1.0;
+  sys->base = 0;
+  for (int r = 0; r < sys->rank; r++) {
+    double d = (double)sys->A[r][sys->pivot_col[r]];
+    sys->base += (double)sys->b[r] / d;
+    magnitude += fabs((double)sys->b[r] / d);
+  }
+  for (int k = 0; k < sys->num_free; k++) {
+    int f = sys->free_vars[k];
+    double c = 1.0, moved = 0;
+    for (int r = 0; r < sys->rank; r++) {
+      double a = (double)sys->A[r][f] / (double)sys->A[r][sys->pivot_col[r]];
+      c -= a;
+      moved += fabs(a);
+    }
+    sys->cost[f] = c;
+    span[f] = (double)sys->upper_bound[f] * moved;
+    magnitude += (double)sys->upper_bound[f] * (1.0 + moved);
+  }
+  sys->slack = 1e-9 * magnitude;
 
-    int p = -1;
-    for (int j = 0; j < sys->cols; j++) {
-      if (fabs(sys->A[i][j]) > EPSILON) { // First non-zero is pivot
-        p = j;
-        is_pivot[j] = 1;
+  // Fix the free variables that move the pivots the most first: their
+  // choice narrows the intervals of the others the fastest
+  for (int k = 1; k < sys->num_free; k++) {
+    int f = sys->free_vars[k], i = k;
+    for (; i > 0 && span[sys->free_vars[i - 1]] < span[f]; i--)
+      sys->free_vars[i] = sys->free_vars[i - 1];
+    sys->free_vars[i] = f;
+  }
+  sys->cost_tail[sys->num_free] = 0;
+  for (int k = sys->num_free - 1; k >= 0; k--) {
+    int f = sys->free_vars[k];
+    sys->cost_tail[k] = sys->cost_tail[k + 1] +
+                        fmin(0.0, sys->cost[f]) * (double)sys->upper_bound[f];
+  }
+
+  // --- Phase 4: Search for Minimal Integer Solution ---
+  long long *solution = arena_alloc(scratch, sys->cols * sizeof(long long));
+  search(sys, 0, solution, 0, 0.0);
+  return true;
+}
+
+/* ========================================================================== */
+/*  Integer Linear Programming Engine                                         */
+/*  minimise sum(x) subject to Ax = b, x >= 0, x integer                      */
+/* ========================================================================== */
+
+/**
+ * Dense Simplex Tableau
+ * Row i < m is a constraint in canonical form (basis[i] has coefficient 1
+ * there and 0 everywhere else). Row m is the objective: reduced costs, with
+ * -z in the last column. Column n holds the right-hand side.
+ */
+typedef struct {
+  int m, n;   // Number of constraint rows and variable columns
+  int stride; // Row length (n + 1)
+  double *t;  // (m + 1) x (n + 1) values, row major
+  int *basis; // Basic variable of each row
+} Tableau;
+
+#define T(tab, i, j) ((tab)->t[(size_t)(i) * (tab)->stride + (j)])
+
+/**
+ * State of one machine's ILP solve. Hitting a limit ends the affected part of
+ * the solve early and sets capped; the search still proves the answer.
+ */
+typedef struct {
+  System *sys;
+  long long best; // Best total found so far (-1 if none)
+  long nodes;     // Branch-and-bound nodes visited
+  int depth;      // Branching depth of the current node
+  bool capped;    // A pivot or node limit was hit
+} Ilp;
+
+/**
+ * Helper: Allocates a zeroed tableau.
+ */
+Tableau *tableau_new(int m, int n) {
+  Tableau *tab = malloc(sizeof(Tableau));
+  tab->m = m;
+  tab->n = n;
+  tab->stride = n + 1;
+  tab->t = calloc((size_t)(m + 1) * (n + 1), sizeof(double));
+  tab->basis = malloc((m + 1) * sizeof(int));
+  return tab;
+}
+
+void tableau_free(Tableau *tab) {
+  free(tab->t);
+  free(tab->basis);
+  free(tab);
+}
+
+/**
+ * Pivots on (row, col): col enters the basis, basis[row] leaves.
+ */
+void pivot(Tableau *tab, int row, int col) {
+  double div = T(tab, row, col);
+  for (int j = 0; j <= tab->n; j++)
+    T(tab, row, j) /= div;
+
+  for (int i = 0; i <= tab->m; i++) {
+    if (i == row)
+      continue;
+    double factor = T(tab, i, col);
+    if (fabs(factor) < LP_EPS)
+      continue;
+    for (int j = 0; j <= tab->n; j++)
+      T(tab, i, j) -= factor * T(tab, row, j);
+    T(tab, i, col) = 0.0;
+  }
+  tab->basis[row] = col;
+}
+
+/**
+ * Primal Simplex with Bland's rule (first improving column, lowest basis
+ * index on ties) so it can't cycle on degenerate systems.
+ * @return false if the LP is unbounded, or if it ran out of pivots (then
+ * ilp->capped is set).
+ */
+bool primal_simplex(Tableau *tab, Ilp *ilp) {
+  for (int pivots = 0;; pivots++) {
+    if (pivots == MAX_PIVOTS) {
+      ilp->capped = true;
+      return false;
+    }
+    int col = -1;
+    for (int j = 0; j < tab->n; j++) {
+      if (T(tab, tab->m, j) < -LP_EPS) {
+        col = j;
         break;
       }
     }
-    sys->pivot_col[i] = p;
+    if (col == -1)
+      return true; // Optimal
+
+    int row = -1;
+    double best = 0;
+    for (int i = 0; i < tab->m; i++) {
+      double a = T(tab, i, col);
+      if (a <= LP_EPS)
+        continue;
+      double ratio = T(tab, i, tab->n) / a;
+      if (row == -1 || ratio < best - LP_EPS ||
+          (ratio < best + LP_EPS && tab->basis[i] < tab->basis[row])) {
+        row = i;
+        best = ratio;
+      }
+    }
+    if (row == -1)
+      return false; // Unbounded
+    pivot(tab, row, col);
   }
+}
 
-  // Any column that isn't a pivot is a Free Variable
-  for (int j = 0; j < sys->cols; j++) {
-    if (!is_pivot[j]) {
-      sys->free_vars[sys->num_free++] = j;
+/**
+ * Dual Simplex: restores primal feasibility (all right-hand sides >= 0) of a
+ * tableau that is still dual feasible. This is the warm start after adding a
+ * branching bound to an already optimal tableau.
+ * * The leaving row is the most negative one, until DEGENERATE_RUN pivots in a
+ * row leave the objective unchanged; from then on it is Bland's rule (the
+ * infeasible row with the lowest basic variable), which can't cycle. Ties in
+ * the ratio test always go to the lowest column.
+ * @return false if the LP became infeasible, or if it ran out of pivots
+ * (then ilp->capped is set).
+ */
+bool dual_simplex(Tableau *tab, Ilp *ilp) {
+  int stalled = 0;
+  for (int pivots = 0;; pivots++) {
+    bool bland = stalled >= DEGENERATE_RUN;
+    int row = -1;
+    for (int i = 0; i < tab->m; i++) {
+      if (T(tab, i, tab->n) >= -LP_EPS)
+        continue;
+      if (row == -1 ||
+          (bland ? tab->basis[i] < tab->basis[row]
+                 : T(tab, i, tab->n) < T(tab, row, tab->n)))
+        row = i;
     }
+    if (row == -1)
+      return true; // Feasible again, and still optimal
+    if (pivots == MAX_PIVOTS) {
+      ilp->capped = true;
+      return false;
+    }
+
+    int col = -1;
+    double best = 0;
+    for (int j = 0; j < tab->n; j++) {
+      double a = T(tab, row, j);
+      if (a >= -LP_EPS)
+        continue;
+      double ratio = T(tab, tab->m, j) / -a;
+      if (col == -1 || ratio < best - LP_EPS) {
+        col = j;
+        best = ratio;
+      }
+    }
+    if (col == -1)
+      return false; // Infeasible
+
+    double z = T(tab, tab->m, tab->n);
+    pivot(tab, row, col);
+    if (fabs(T(tab, tab->m, tab->n) - z) <= LP_EPS)
+      stalled++;
+    else
+      stalled = 0;
+  }
+}
+
+/**
+ * Returns a copy of tab with one extra row and slack column for the
+ * constraint sum(coef[j] * x_j) <= rhs over the existing columns. The new
+ * row is rewritten in terms of the non-basic variables, so the tableau stays
+ * canonical with the slack as its basic variable.
+ */
+Tableau *add_constraint(Tableau *tab, double *coef, double rhs) {
+  Tableau *out = tableau_new(tab->m + 1, tab->n + 1);
+  int slack = tab->n;
+
+  for (int i = 0; i < tab->m; i++) {
+    for (int j = 0; j < tab->n; j++)
+      T(out, i, j) = T(tab, i, j);
+    T(out, i, out->n) = T(tab, i, tab->n);
+    out->basis[i] = tab->basis[i];
+  }
+
+  int r = tab->m;
+  for (int j = 0; j < tab->n; j++)
+    T(out, r, j) = coef[j];
+  T(out, r, slack) = 1.0;
+  T(out, r, out->n) = rhs;
+  out->basis[r] = slack;
+
+  // Eliminate basic variables from the new row
+  for (int i = 0; i < tab->m; i++) {
+    double factor = T(out, r, tab->basis[i]);
+    if (fabs(factor) < LP_EPS)
+      continue;
+    for (int j = 0; j <= out->n; j++)
+      T(out, r, j) -= factor * T(out, i, j);
   }
 
-  // --- Phase 3: Search for Minimal Integer Solution ---
-  double solution[MAX_VARS] = {0};
-  global_min_presses = -1;
-  search(sys, 0, solution);
+  // Objective row moves down one place; the slack has zero cost
+  for (int j = 0; j < tab->n; j++)
+    T(out, out->m, j) = T(tab, tab->m, j);
+  T(out, out->m, out->n) = T(tab, tab->m, tab->n);
+  return out;
+}
+
+/**
+ * Builds the optimal LP relaxation tableau of the machine with the two-phase
+ * method: Phase 1 drives artificial variables out of the basis, Phase 2
+ * minimises the number of presses.
+ * @return The tableau, or NULL if even the relaxation has no solution.
+ */
+Tableau *solve_relaxation(System *sys, Ilp *ilp) {
+  int m = sys->rows, n = sys->cols;
+
+  // --- Phase 1: Ax + a = b, minimise sum(a) ---
+  Tableau *tab = tableau_new(m, n + m);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++)
+      T(tab, i, j) = (double)sys->A[i][j];
+    T(tab, i, n + i) = 1.0;
+    T(tab, i, tab->n) = (double)sys->b[i];
+    tab->basis[i] = n + i;
+
+    // Reduced costs of the Phase 1 objective
+    for (int j = 0; j < n; j++)
+      T(tab, m, j) -= T(tab, i, j);
+    T(tab, m, tab->n) -= T(tab, i, tab->n);
+  }
+  primal_simplex(tab, ilp);
+
+  if (ilp->capped || -T(tab, m, tab->n) > LP_EPS) {
+    tableau_free(tab);
+    return NULL; // Artificials can't reach zero: Ax = b is infeasible
+  }
+
+  // Pivot artificials that stayed basic (at zero) out of the basis. If the
+  // row has no structural entry left, it is redundant and is dropped.
+  bool *keep = malloc(m * sizeof(bool));
+  int kept = 0;
+  for (int i = 0; i < m; i++) {
+    keep[i] = true;
+    if (tab->basis[i] < n)
+      continue;
+    int col = -1;
+    for (int j = 0; j < n && col == -1; j++)
+      if (fabs(T(tab, i, j)) > LP_EPS)
+        col = j;
+    if (col == -1)
+      keep[i] = false;
+    else
+      pivot(tab, i, col);
+  }
+  for (int i = 0; i < m; i++)
+    kept += keep[i];
+
+  // --- Phase 2: drop artificials, minimise sum(x) ---
+  Tableau *out = tableau_new(kept, n);
+  int r = 0;
+  for (int i = 0; i < m; i++) {
+    if (!keep[i])
+      continue;
+    for (int j = 0; j < n; j++)
+      T(out, r, j) = T(tab, i, j);
+    T(out, r, n) = T(tab, i, tab->n);
+    out->basis[r] = tab->basis[i];
+    r++;
+  }
+  free(keep);
+  tableau_free(tab);
+
+  // Reduced costs: c_j - c_B * column_j, with every cost equal to 1
+  for (int j = 0; j < n; j++)
+    T(out, kept, j) = 1.0;
+  for (int i = 0; i < kept; i++)
+    for (int j = 0; j <= n; j++)
+      T(out, kept, j) -= T(out, i, j);
+
+  primal_simplex(out, ilp); // Bounded: sum(x) >= 0
+  if (ilp->capped) {
+    tableau_free(out);
+    return NULL;
+  }
+  return out;
+}
+
+/**
+ * Helper: Checks an integer candidate exactly against the original system.
+ */
+bool check_solution(System *sys, long long *x) {
+  for (int j = 0; j < sys->cols; j++)
+    if (x[j] < 0)
+      return false;
+  for (int i = 0; i < sys->rows; i++) {
+    long long sum = 0;
+    for (int j = 0; j < sys->cols; j++)
+      sum += sys->A[i][j] * x[j];
+    if (sum != sys->b[i])
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Branch-and-Bound over the LP relaxation.
+ * * Each node branches on the most fractional structural variable
+ * (x_j <= floor(v) and x_j >= ceil(v)). Children start from a copy of the
+ * parent's optimal tableau and only need a few dual simplex pivots (warm
+ * start). Since the objective is a sum of integers, a node is pruned once
+ * ceil(LP value) can't beat the best total. All of this is in floating
+ * point, so the result is only a candidate: it is checked exactly, and the
+ * search decides whether it is minimal.
+ * * @param tab Optimal tableau of this node (freed before returning).
+ * @param ilp In/out: best total so far, node count and limit flag.
+ */
+void branch_and_bound(Ilp *ilp, Tableau *tab) {
+  System *sys = ilp->sys;
+  int n = sys->cols;
+
+  if (++ilp->nodes > MAX_NODES || ilp->depth > MAX_DEPTH) {
+    ilp->capped = true;
+    tableau_free(tab);
+    return;
+  }
+
+  // Bound: the LP value z is a lower bound for every integer solution below,
+  // and so is ceil(z) since totals are integers. z carries rounding error, so
+  // it is rounded with a tolerance that grows with its size.
+  double z = -T(tab, tab->m, tab->n);
+  double bound = ceil(z - INT_EPS * fmax(1.0, fabs(z)));
+  if (ilp->best != -1 && bound >= (double)ilp->best) {
+    tableau_free(tab);
+    return;
+  }
+
+  // Integer vertex: verify exactly and record
+  bool integral = true;
+  for (int i = 0; i < tab->m && integral; i++) {
+    double v = T(tab, i, tab->n);
+    integral = tab->basis[i] >= n || fabs(v - round(v)) <= INT_EPS;
+  }
+  if (integral) {
+    long long *x = calloc(n, sizeof(long long));
+    for (int i = 0; i < tab->m; i++)
+      if (tab->basis[i] < n)
+        x[tab->basis[i]] = llround(T(tab, i, tab->n));
+    long long total = 0;
+    for (int j = 0; j < n; j++)
+      total += x[j];
+    if (check_solution(sys, x) && (ilp->best == -1 || total < ilp->best))
+      ilp->best = total;
+    free(x);
+    tableau_free(tab);
+    return;
+  }
+
+  // Branch on x_j around its fractional value v
+  int row = -1;
+  double row_best = 0;
+  for (int i = 0; i < tab->m; i++) {
+    double v = T(tab, i, tab->n);
+    double f = fabs(v - round(v));
+    if (tab->basis[i] < n && f > INT_EPS && f > row_best) {
+      row_best = f;
+      row = i;
+    }
+  }
+  int var = tab->basis[row];
+  double v = T(tab, row, tab->n);
+
+  double *coef = calloc(tab->n, sizeof(double));
+  for (int dir = 0; dir < 2; dir++) {
+    // Explore the nearer side first: it usually finds a good bound sooner
+    bool down = (dir == 0) == (v - floor(v) < 0.5);
+    coef[var] = down ? 1.0 : -1.0;
+    double rhs = down ? floor(v) : -ceil(v);
+
+    Tableau *child = add_constraint(tab, coef, rhs);
+    if (dual_simplex(child, ilp)) {
+      ilp->depth++;
+      branch_and_bound(ilp, child);
+      ilp->depth--;
+    } else
+      tableau_free(child);
+    if (ilp->nodes > MAX_NODES)
+      break;
+  }
+  free(coef);
+  tableau_free(tab);
+}
+
+/**
+ * Column order for solve_system(): the basic structural columns of the LP
+ * optimum first, then the rest, each group left to right. Without a
+ * tableau (the relaxation failed) it is plain left to right.
+ */
+void basic_columns_first(const Tableau *tab, int cols, int *columns) {
+  bool *basic = calloc(cols, sizeof(bool));
+  if (tab)
+    for (int i = 0; i < tab->m; i++)
+      if (tab->basis[i] < cols)
+        basic[tab->basis[i]] = true;
+  int k = 0;
+  for (int pass = 1; pass >= 0; pass--)
+    for (int j = 0; j < cols; j++)
+      if (basic[j] == pass)
+        columns[k++] = j;
+  free(basic);
+}
+
+/**
+ * Runs the ILP engine on one machine: the LP relaxation, then (if branch is
+ * set) branch-and-bound. columns receives the order for solve_system().
+ * @return The best total it found, -1 if none. Its solution satisfies the
+ * system exactly, but the total is not proven minimal: rounding or a limit
+ * can make it miss the optimum, or miss every solution.
+ */
+long long solve_ilp(System *sys, int *columns, bool branch) {
+  Ilp ilp = {.sys = sys, .best = -1};
+  Tableau *tab;
+  PHASE("simplex") tab = solve_relaxation(sys, &ilp);
+  basic_columns_first(tab, sys->cols, columns);
+  if (tab && branch)
+    PHASE("branch") branch_and_bound(&ilp, tab);
+  else if (tab)
+    tableau_free(tab);
+  return ilp.best;
 }
 
 /**
  * Parses input string into System struct.
  * Expected format includes (...) for buttons and {...} for targets.
+ * * The line is read twice: the first pass only measures the system (buttons,
+ * highest counter index, number of targets), the second fills a matrix of
+ * exactly that size allocated from the arena.
  */
-void parse_line(char *line, System *sys) {
+void parse_line(char *line, System *sys, Arena *arena) {
+  char *brace = strchr(line, '{');
+  char *brace_end = brace ? strchr(brace, '}') : NULL;
   sys->rows = 0;
   sys->cols = 0;
-  memset(sys->A, 0, sizeof(sys->A));
-  memset(sys->b, 0, sizeof(sys->b));
 
-  // Parse Buttons: "(1,2) (3)"
-  char *p = line;
-  char *brace = strchr(line, '{');
+  for (int pass = 0; pass < 2; pass++) {
+    // Parse Buttons: "(1,2) (3)"
+    int col = 0;
+    char *p = line;
+    while ((p = strchr(p, '(')) != NULL) {
+      if (brace && p > brace)
+        break; // Don't parse inside {}
 
-  while ((p = strchr(p, '(')) != NULL) {
-    if (brace && p > brace)
-      break; // Don't parse inside {}
-
-    char *end = strchr(p, ')');
-    if (!end)
-      break;
+      char *end = strchr(p, ')');
+      if (!end)
+        break;
 
-    char buf[256];
-    int l = end - p - 1;
-    if (l > 255)
-      l = 255;
-    strncpy(buf, p + 1, l);
-    buf[l] = 0;
-
-    char *tok = strtok(buf, ",");
-    while (tok) {
-      int r = atoi(tok);
-      // Expand rows if a button affects a higher index counter
-      if (r >= sys->rows)
-        sys->rows = r + 1;
-      sys->A[r][sys->cols] = 1.0;
-      tok = strtok(NULL, ",");
+      for (char *q = p + 1; q < end;) {
+        if (*q < '0' || *q > '9') {
+          q++;
+          continue;
+        }
+        int r = (int)strtol(q, &q, 10);
+        if (pass == 0) {
+          // Expand rows if a button affects a higher index counter
+          if (r >= sys->rows)
+            sys->rows = r + 1;
+        } else {
+          sys->A[r][col] = 1;
+        }
+      }
+      col++; // Move to next button (variable)
+      p = end + 1;
     }
-    sys->cols++; // Move to next button (variable)
-    p = end + 1;
-  }
-
-  // Parse Targets: "{3, 5, ...}"
-  if (brace) {
-    char *end = strchr(brace, '}');
-    if (end) {
-      char buf[256];
-      int l = end - brace - 1;
-      if (l > 255)
-        l = 255;
-      strncpy(buf, brace + 1, l);
-      buf[l] = 0;
-
-      int idx = 0;
-      char *tok = strtok(buf, ",");
-      while (tok) {
-        sys->b[idx] = atof(tok);
-        if (idx >= sys->rows)
-          sys->rows = idx + 1;
+
+    // Parse Targets: "{3, 5, ...}"
+    int idx = 0;
+    if (brace && brace_end) {
+      for (char *q = brace + 1; q < brace_end;) {
+        if (*q < '0' || *q > '9') {
+          q++;
+          continue;
+        }
+        long long v = strtoll(q, &q, 10);
+        if (pass == 1)
+          sys->b[idx] = v;
         idx++;
-        tok = strtok(NULL, ",");
       }
     }
+
+    if (pass == 0) {
+      sys->cols = col;
+      if (idx > sys->rows)
+        sys->rows = idx;
+      alloc_system(sys, arena);
+    }
+  }
+}
+
+/* ========================================================================== */
+/*  Parallel Machine Solver                                                   */
+/* ========================================================================== */
+
+/**
+ * One machine of the input, solved independently of all others.
+ */
+typedef struct {
+  System sys;
+  int expected_free;   // Scheduling estimate: buttons beyond the counter count
+  long long presses;   // Result (-1 if no solution)
+  long long reference; // --check: result of the search engine
+  bool overflow;       // The search outgrew 64 bits and couldn't run
+  bool capped;         // The search hit its node limit
+} Job;
+
+/**
+ * Engine selection: ILP (default), free-variable search, or both.
+ */
+typedef enum { ENGINE_ILP, ENGINE_SEARCH, ENGINE_CHECK } Engine;
+
+/**
+ * Per-thread work queue. The owner takes jobs from the front (hardest
+ * first), idle threads steal from the back.
+ */
+typedef struct {
+  Job **items;
+  int head, tail;
+  pthread_mutex_t lock;
+} Deque;
+
+typedef struct {
+  Deque *deques;
+  int num_threads;
+  Engine engine;
+} Pool;
+
+typedef struct {
+  Pool *pool;
+  int id;
+  Arena scratch; // Per-thread temporaries, reset after every machine
+} Worker;
+
+/**
+ * Comparison function for qsort: most expected free variables first.
+ */
+int compare_jobs(const void *a, const void *b) {
+  const Job *j1 = *(Job *const *)a;
+  const Job *j2 = *(Job *const *)b;
+  return j2->expected_free - j1->expected_free;
+}
+
+/**
+ * Returns the next job for thread id: from its own queue first, otherwise
+ * stolen from another thread. Returns NULL once every queue is empty.
+ */
+Job *take_job(Pool *pool, int id) {
+  for (int k = 0; k < pool->num_threads; k++) {
+    Deque *dq = &pool->deques[(id + k) % pool->num_threads];
+    Job *job = NULL;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail)
+      job = (k == 0) ? dq->items[dq->head++] : dq->items[--dq->tail];
+    pthread_mutex_unlock(&dq->lock);
+    if (job)
+      return job;
+  }
+  return NULL;
+}
+
+/**
+ * Solves one machine with the selected engine. The answer always comes from
+ * the exact search (seeded with the ILP's solution by default); when the
+ * search can't run (overflow) or stops early (capped), the job is flagged.
+ */
+void solve_job(Job *job, Engine engine, Arena *scratch) {
+  int *columns = arena_alloc(scratch, job->sys.cols * sizeof(int));
+  long long incumbent =
+      solve_ilp(&job->sys, columns, engine != ENGINE_SEARCH);
+
+  // solve_system() reduces the matrix in place, so it works on a copy
+  System copy;
+  copy_system(&copy, &job->sys, scratch);
+  if (engine == ENGINE_CHECK) {
+    job->presses = incumbent;
+    incumbent = -1; // Compare against a search that doesn't know it
   }
+  job->overflow = !solve_system(&copy, columns, incumbent, scratch);
+  if (job->overflow) {
+    // Best effort, reported as unproven
+    if (engine == ENGINE_SEARCH)
+      job->presses = solve_ilp(&job->sys, columns, true);
+    else if (engine == ENGINE_ILP)
+      job->presses = incumbent;
+    return;
+  }
+  job->capped = copy.capped;
+  if (engine == ENGINE_CHECK)
+    job->reference = copy.min_presses;
+  else
+    job->presses = copy.min_presses;
+}
+
+void *solve_worker(void *arg) {
+  Worker *w = (Worker *)arg;
+  Job *job;
+  while ((job = take_job(w->pool, w->id)) != NULL) {
+    solve_job(job, w->pool->engine, &w->scratch);
+    arena_reset(&w->scratch);
+  }
+  arena_free(&w->scratch);
+  return NULL;
 }
 
-int main() {
-  char line[4096];
+/**
+ * Solves every job on a work-stealing thread pool. Jobs are sorted by
+ * expected difficulty and dealt round-robin, so each thread starts with its
+ * share of the hard machines; results stay in input order inside jobs[].
+ */
+void solve_all(Job *jobs, int count, Engine engine) {
+  if (count == 0)
+    return;
+
+  long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > MAX_THREADS)
+    num_threads = MAX_THREADS;
+  if (num_threads > count)
+    num_threads = count;
+
+  Job **order = malloc(count * sizeof(Job *));
+  for (int i = 0; i < count; i++)
+    order[i] = &jobs[i];
+  qsort(order, count, sizeof(Job *), compare_jobs);
+
+  Pool pool;
+  pool.num_threads = num_threads;
+  pool.engine = engine;
+  pool.deques = malloc(num_threads * sizeof(Deque));
+  for (int t = 0; t < num_threads; t++) {
+    pool.deques[t].items = malloc((count / num_threads + 1) * sizeof(Job *));
+    pool.deques[t].head = 0;
+    pool.deques[t].tail = 0;
+    pthread_mutex_init(&pool.deques[t].lock, NULL);
+  }
+  for (int i = 0; i < count; i++) {
+    Deque *dq = &pool.deques[i % num_threads];
+    dq->items[dq->tail++] = order[i];
+  }
+
+  pthread_t threads[MAX_THREADS];
+  Worker workers[MAX_THREADS];
+  for (int t = 0; t < num_threads; t++) {
+    workers[t].pool = &pool;
+    workers[t].id = t;
+    workers[t].scratch.head = NULL;
+    pthread_create(&threads[t], NULL, solve_worker, &workers[t]);
+  }
+  for (int t = 0; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+
+  for (int t = 0; t < num_threads; t++) {
+    pthread_mutex_destroy(&pool.deques[t].lock);
+    free(pool.deques[t].items);
+  }
+  free(pool.deques);
+  free(order);
+}
+
+int main(int argc, char **argv) {
+  char *line = NULL;
+  size_t line_cap = 0;
   long long grand_total = 0;
+  int unproven = 0;
+
+  Engine engine = ENGINE_ILP;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--search") == 0)
+      engine = ENGINE_SEARCH;
+    else if (strcmp(argv[i], "--check") == 0)
+      engine = ENGINE_CHECK;
+  }
+
+  PHASE_MARK("parse");
+  // Read every machine first, then solve them all in parallel. The parsed
+  // systems all live in one arena, sized to each machine.
+  int capacity = 64, count = 0;
+  Job *jobs = malloc(capacity * sizeof(Job));
+  Arena machines = {NULL};
 
-  // Read Input
-  while (fgets(line, sizeof(line), stdin)) {
+  // Read Input (getline: no limit on line length)
+  while (getline(&line, &line_cap, stdin) != -1) {
     if (strlen(line) < 3)
       continue;
     // Basic validation that line contains machine data
     if (!strchr(line, '(') || !strchr(line, '{'))
       continue;
 
-    System sys;
-    parse_line(line, &sys);
+    if (count >= capacity) {
+      capacity *= 2;
+      jobs = realloc(jobs, capacity * sizeof(Job));
+    }
+    Job *job = &jobs[count++];
+    parse_line(line, &job->sys, &machines);
+    job->expected_free = job->sys.cols - job->sys.rows;
+    job->presses = -1;
+    job->reference = -1;
+    job->overflow = false;
+    job->capped = false;
+  }
 
-    solve_system(&sys);
+  PHASE_MARK("solve");
+  solve_all(jobs, count, engine);
 
-    if (global_min_presses != -1) {
-      grand_total += global_min_presses;
+  for (int i = 0; i < count; i++) {
+    const char *engine_name = engine == ENGINE_SEARCH ? "search" : "ILP";
+    if (jobs[i].overflow) {
+      unproven++;
+      fprintf(stderr,
+              "Machine %d: search overflows 64-bit integers, %s answer %lld "
+              "is not proven minimal\n",
+              i + 1, engine_name, jobs[i].presses);
+    } else if (jobs[i].capped) {
+      unproven++;
+      long long found =
+          engine == ENGINE_CHECK ? jobs[i].reference : jobs[i].presses;
+      if (found == -1)
+        fprintf(stderr,
+                "Machine %d: search hit its node limit before finding a "
+                "solution\n",
+                i + 1);
+      else
+        fprintf(stderr,
+                "Machine %d: search hit its node limit, %lld presses is not "
+                "proven minimal\n",
+                i + 1, found);
+    } else if (engine == ENGINE_CHECK &&
+               jobs[i].presses != jobs[i].reference) {
+      fprintf(stderr, "Mismatch on machine %d: ILP %lld, search %lld\n",
+              i + 1, jobs[i].presses, jobs[i].reference);
+    }
+    if (jobs[i].presses != -1) {
+      grand_total += jobs[i].presses;
     }
   }
 
   printf("Total presses: %lld\n", grand_total);
-  return 0;
-}
\ No newline at end of file
+  arena_free(&machines);
+  free(jobs);
+  free(line);
+  return unproven ? 1 : 0;
+}
@@ -1,79 +1,667 @@
 /**
  * Advent of Code 2025 - Day 11: Reactor
  * Problem: Count all paths from node "you" to node "out".
- * Method: Depth First Search (DFS) with Memoization.
+ * Method: CSR graph, Kahn topological sort, then one iterative sweep in
+ * reverse topological order.
+ * Count type: -DCOUNT_MODE=COUNT_U64 (default), COUNT_U128, COUNT_MOD or
+ * COUNT_BIG (see "Path Count Type" below).
+ * Run with --parallel or --threads N to count level by level on a thread
+ * pool; --timing prints the time spent on each level.
  */
 
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-#define MAX_DEVICES 2000
-#define MAX_NAME_LEN 16
-#define MAX_NEIGHBORS 20
+#include "../../common/phase.h"
 
+#define MAX_THREADS 64
+#define SWEEP_CHUNK 64          // Nodes claimed at once by a sweep thread
+#define PARALLEL_MIN_NODES 4096 // Smaller levels run on one thread
+
+/**
+ * Name Interner
+ * Maps device names to dense integer IDs in O(1) expected time.
+ * - All names are stored back to back in one growable string arena.
+ * - The lookup table uses open addressing (linear probing) and stores the
+ * full hash next to each ID, so strcmp only runs on a real hash match.
+ * - Device names are usually 3 characters; names of up to 4 bytes are packed
+ * directly into a uint32 key instead of being hashed byte by byte.
+ */
+typedef struct {
+  char *chars;         // String arena: NUL-terminated names, back to back
+  size_t chars_used;   // Bytes used in the arena
+  size_t chars_cap;    // Arena capacity in bytes
+  size_t *offset;      // offset[id] = start of the name of device id
+  int *slot_id;        // Hash table: device ID, or -1 for an empty slot
+  uint32_t *slot_hash; // Hash table: hash of the name in that slot
+  int capacity;        // Number of slots (power of two)
+  int count;           // Number of interned names
+} Interner;
+
+/**
+ * Hashes a name. Short names are packed into a uint32; longer ones use
+ * FNV-1a. Both go through a final avalanche so every bit of the result
+ * depends on every input byte.
+ */
+uint32_t hash_name(const char *name, size_t len) {
+  uint32_t h;
+  if (len <= 4) {
+    h = 0;
+    memcpy(&h, name, len);
+  } else {
+    h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+      h ^= (unsigned char)name[i];
+      h *= 16777619u;
+    }
+  }
+  // Final mix (MurmurHash3 fmix32)
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * Doubles the hash table and re-inserts every ID.
+ */
+void interner_grow(Interner *in) {
+  int old_capacity = in->capacity;
+  int *old_id = in->slot_id;
+  uint32_t *old_hash = in->slot_hash;
+
+  in->capacity = old_capacity ? old_capacity * 2 : 1024;
+  in->slot_id = malloc(in->capacity * sizeof(int));
+  in->slot_hash = malloc(in->capacity * sizeof(uint32_t));
+  in->offset = realloc(in->offset, (in->capacity / 2) * sizeof(size_t));
+  for (int i = 0; i < in->capacity; i++)
+    in->slot_id[i] = -1;
+
+  int mask = in->capacity - 1;
+  for (int i = 0; i < old_capacity; i++) {
+    if (old_id[i] == -1)
+      continue;
+    int s = old_hash[i] & mask;
+    while (in->slot_id[s] != -1)
+      s = (s + 1) & mask;
+    in->slot_id[s] = old_id[i];
+    in->slot_hash[s] = old_hash[i];
+  }
+  free(old_id);
+  free(old_hash);
+}
+
+/**
+ * Finds the slot holding name, or the empty slot where it would go.
+ */
+int interner_probe(Interner *in, const char *name, uint32_t h) {
+  int mask = in->capacity - 1;
+  int s = h & mask;
+  while (in->slot_id[s] != -1) {
+    if (in->slot_hash[s] == h &&
+        strcmp(in->chars + in->offset[in->slot_id[s]], name) == 0)
+      return s;
+    s = (s + 1) & mask;
+  }
+  return s;
+}
+
+/**
+ * Returns the ID of an already interned name, or -1.
+ */
+int interner_find(Interner *in, const char *name) {
+  if (in->count == 0)
+    return -1;
+  size_t len = strlen(name);
+  return in->slot_id[interner_probe(in, name, hash_name(name, len))];
+}
+
+/**
+ * Returns the ID of name, interning it as the next free ID if it is new.
+ * *is_new is set when the name had not been seen before.
+ */
+int interner_add(Interner *in, const char *name, int *is_new) {
+  // Keep the load factor at or below 1/2
+  if (2 * (in->count + 1) > in->capacity)
+    interner_grow(in);
+
+  size_t len = strlen(name);
+  uint32_t h = hash_name(name, len);
+  int s = interner_probe(in, name, h);
+  *is_new = (in->slot_id[s] == -1);
+  if (!*is_new)
+    return in->slot_id[s];
+
+  // Copy the name into the string arena
+  if (in->chars_used + len + 1 > in->chars_cap) {
+    in->chars_cap = in->chars_cap ? in->chars_cap * 2 : 4096;
+    while (in->chars_used + len + 1 > in->chars_cap)
+      in->chars_cap *= 2;
+    in->chars = realloc(in->chars, in->chars_cap);
+  }
+  memcpy(in->chars + in->chars_used, name, len + 1);
+
+  int id = in->count++;
+  in->offset[id] = in->chars_used;
+  in->chars_used += len + 1;
+  in->slot_id[s] = id;
+  in->slot_hash[s] = h;
+  return id;
+}
+
+/**
+ * Returns the name of device id.
+ */
+const char *interner_name(Interner *in, int id) {
+  return in->chars + in->offset[id];
+}
+
+/**
+ * Path Count Type
+ * Path counts grow exponentially with the depth of the DAG, so the type used
+ * for them is chosen at compile time with -DCOUNT_MODE=...:
+ * - COUNT_U64  (default) 64-bit counts; overflow is detected and reported.
+ * - COUNT_U128 128-bit counts; overflow is detected and reported.
+ * - COUNT_MOD  counts modulo COUNT_MODULUS (default 1e9+7, must be < 2^63).
+ * - COUNT_BIG  arbitrary precision (base 2^32 limbs); never overflows.
+ * Every mode uses all-zero bytes for the value 0, so count arrays can be
+ * calloc'd or memset. The fixed-width adds are branch-free and return the
+ * carry, which keeps the inner loop of the sweep vectorisable (the 64-bit
+ * compare needs more than SSE2, e.g. gcc -O3 -march=native).
+ */
+#define COUNT_U64 0
+#define COUNT_U128 1
+#define COUNT_MOD 2
+#define COUNT_BIG 3
+
+#ifndef COUNT_MODE
+#define COUNT_MODE COUNT_U64
+#endif
+
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_MOD
+typedef unsigned long long Count;
+#elif COUNT_MODE == COUNT_U128
+typedef unsigned __int128 Count;
+#elif COUNT_MODE == COUNT_BIG
 typedef struct {
-  char name[MAX_NAME_LEN];
-  int id;
-} DeviceMap;
+  int len;        // Number of limbs in use (0 for the value 0)
+  int cap;        // Allocated limbs
+  uint32_t *limb; // Little-endian base 2^32 digits
+} Count;
+#else
+#error "Unknown COUNT_MODE"
+#endif
+
+#if COUNT_MODE == COUNT_MOD
+#ifndef COUNT_MODULUS
+#define COUNT_MODULUS 1000000007ULL
+#endif
+#endif
+
+int count_overflow = 0; // Set once any count has wrapped around
+
+#if COUNT_MODE == COUNT_BIG
+void big_reserve(Count *c, int cap) {
+  if (c->cap >= cap)
+    return;
+  c->cap = cap < 4 ? 4 : cap;
+  c->limb = realloc(c->limb, c->cap * sizeof(uint32_t));
+}
+#endif
+
+/**
+ * Sets c to a small value (0 or 1 in practice).
+ */
+static inline void count_set(Count *c, unsigned v) {
+#if COUNT_MODE == COUNT_BIG
+  c->len = 0;
+  if (v) {
+    big_reserve(c, 1);
+    c->limb[c->len++] = v;
+  }
+#else
+  *c = v;
+#endif
+}
+
+/**
+ * acc += x.
+ * @return 1 if a fixed-width count overflowed, 0 otherwise.
+ */
+static inline int count_add(Count *acc, const Count *x) {
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_U128
+  Count s = *acc + *x;
+  int carry = s < *acc;
+  *acc = s;
+  return carry;
+#elif COUNT_MODE == COUNT_MOD
+  Count s = *acc + *x;
+  *acc = s >= COUNT_MODULUS ? s - COUNT_MODULUS : s;
+  return 0;
+#else
+  if (x->len == 0)
+    return 0;
+  int len = acc->len > x->len ? acc->len : x->len;
+  big_reserve(acc, len + 1);
+  uint64_t carry = 0;
+  for (int i = 0; i < len; i++) {
+    uint64_t s = carry;
+    if (i < acc->len)
+      s += acc->limb[i];
+    if (i < x->len)
+      s += x->limb[i];
+    acc->limb[i] = (uint32_t)s;
+    carry = s >> 32;
+  }
+  acc->len = len;
+  if (carry)
+    acc->limb[acc->len++] = (uint32_t)carry;
+  return 0;
+#endif
+}
+
+/**
+ * Releases the storage of a count (only the bignum mode owns any).
+ */
+static inline void count_free(Count *c) {
+#if COUNT_MODE == COUNT_BIG
+  free(c->limb);
+  c->limb = NULL;
+  c->len = c->cap = 0;
+#else
+  (void)c;
+#endif
+}
+
+/**
+ * Prints a count in decimal to stdout.
+ */
+void count_print(const Count *c) {
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_MOD
+  printf("%llu", *c);
+#else
+  // Split into base 10^9 chunks, least significant first
+#if COUNT_MODE == COUNT_U128
+  Count v = *c;
+  uint32_t chunk[5];
+  int n = 0;
+  do {
+    chunk[n++] = (uint32_t)(v % 1000000000u);
+    v /= 1000000000u;
+  } while (v);
+#else
+  int len = c->len;
+  uint32_t *work = malloc((len + 1) * sizeof(uint32_t));
+  uint32_t *chunk = malloc((len * 10 / 9 + 2) * sizeof(uint32_t));
+  memcpy(work, c->limb, len * sizeof(uint32_t));
+  int n = 0;
+  do {
+    uint64_t rem = 0;
+    for (int i = len - 1; i >= 0; i--) {
+      uint64_t cur = (rem << 32) | work[i];
+      work[i] = (uint32_t)(cur / 1000000000u);
+      rem = cur % 1000000000u;
+    }
+    chunk[n++] = (uint32_t)rem;
+    while (len > 0 && work[len - 1] == 0)
+      len--;
+  } while (len > 0);
+#endif
+  printf("%u", chunk[n - 1]);
+  for (int i = n - 2; i >= 0; i--)
+    printf("%09u", chunk[i]);
+#if COUNT_MODE == COUNT_BIG
+  free(work);
+  free(chunk);
+#endif
+#endif
+}
 
-// Graph structure
-int adj[MAX_DEVICES][MAX_NEIGHBORS]; // Adjacency list
-int adj_count[MAX_DEVICES];          // Number of neighbors for each node
-int num_devices = 0;
+// Graph in CSR form: the neighbors of u are target[offset[u] .. offset[u+1]-1]
+typedef struct {
+  int num_nodes;
+  int num_edges;
+  int *offset;    // num_nodes + 1 entries
+  int *target;    // num_edges entries
+  int *topo;      // Nodes in topological order, then the unreached ones
+  int *topo_pos;  // Position of each node in topo
+  int num_sorted; // Nodes reached from the sources: topo[0 .. num_sorted-1]
+} Graph;
 
-DeviceMap map[MAX_DEVICES];
+// Edge list collected while parsing
+int *edge_from = NULL;
+int *edge_to = NULL;
+int num_edges = 0;
+int edge_capacity = 0;
 
-// Memoization array: stores path counts for each node. -1 means not calculated
-// yet.
-long long memo[MAX_DEVICES];
+Interner names; // Name-to-ID lookup
 
 // --- Helper: Get or Create ID for a name ---
 int get_id(char *name) {
-  for (int i = 0; i < num_devices; i++) {
-    if (strcmp(map[i].name, name) == 0) {
-      return i;
+  int is_new;
+  return interner_add(&names, name, &is_new);
+}
+
+// --- Helper: Append edge u -> v ---
+void add_edge(int u, int v) {
+  if (num_edges == edge_capacity) {
+    edge_capacity = edge_capacity ? edge_capacity * 2 : 1024;
+    edge_from = realloc(edge_from, edge_capacity * sizeof(int));
+    edge_to = realloc(edge_to, edge_capacity * sizeof(int));
+  }
+  edge_from[num_edges] = u;
+  edge_to[num_edges] = v;
+  num_edges++;
+}
+
+// --- Build CSR in two passes, then topological order (Kahn) ---
+// Only nodes reachable from the sources are sorted: edges never leave that
+// set, so it is all the sweeps read. Returns -1 if it has a cycle (a cycle
+// elsewhere in the file doesn't matter).
+int build_graph(Graph *g, int num_nodes, const int *sources,
+                int num_sources) {
+  g->num_nodes = num_nodes;
+  g->num_edges = num_edges;
+  g->offset = calloc(num_nodes + 1, sizeof(int));
+  g->target = malloc((num_edges + 1) * sizeof(int));
+  g->topo = malloc((num_nodes + 1) * sizeof(int));
+  g->topo_pos = malloc((num_nodes + 1) * sizeof(int));
+
+  // Pass 1: count out-degrees, prefix sum gives the start of each row
+  for (int e = 0; e < num_edges; e++)
+    g->offset[edge_from[e] + 1]++;
+  for (int u = 0; u < num_nodes; u++)
+    g->offset[u + 1] += g->offset[u];
+
+  // Pass 2: place edges
+  int *next = malloc((num_nodes + 1) * sizeof(int));
+  memcpy(next, g->offset, num_nodes * sizeof(int));
+  for (int e = 0; e < num_edges; e++)
+    g->target[next[edge_from[e]]++] = edge_to[e];
+
+  // Reachable set: depth-first from the sources, topo[] as the stack
+  char *reached = calloc(num_nodes + 1, 1);
+  int num_reached = 0, top = 0;
+  for (int i = 0; i < num_sources; i++)
+    if (!reached[sources[i]]) {
+      reached[sources[i]] = 1;
+      g->topo[top++] = sources[i];
     }
+  while (top > 0) {
+    int u = g->topo[--top];
+    num_reached++;
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+      if (!reached[g->target[e]]) {
+        reached[g->target[e]] = 1;
+        g->topo[top++] = g->target[e];
+      }
   }
-  // New device found
-  strcpy(map[num_devices].name, name);
-  map[num_devices].id = num_devices;
-  adj_count[num_devices] = 0;
-  memo[num_devices] = -1; // Initialize memo
-  return num_devices++;
+
+  // Kahn on the reached nodes: topo[] is also the queue
+  int *in_degree = next;
+  memset(in_degree, 0, num_nodes * sizeof(int));
+  for (int u = 0; u < num_nodes; u++)
+    if (reached[u])
+      for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+        in_degree[g->target[e]]++;
+
+  int head = 0, tail = 0;
+  for (int u = 0; u < num_nodes; u++)
+    if (reached[u] && in_degree[u] == 0)
+      g->topo[tail++] = u;
+  while (head < tail) {
+    int u = g->topo[head++];
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+      if (--in_degree[g->target[e]] == 0)
+        g->topo[tail++] = g->target[e];
+  }
+  free(in_degree);
+
+  int sorted = tail;
+  for (int u = 0; u < num_nodes; u++)
+    if (!reached[u])
+      g->topo[tail++] = u;
+  free(reached);
+  if (sorted != num_reached)
+    return -1;
+
+  g->num_sorted = sorted;
+  for (int i = 0; i < tail; i++)
+    g->topo_pos[g->topo[i]] = i;
+  return 0;
+}
+
+void free_graph(Graph *g) {
+  free(g->offset);
+  free(g->target);
+  free(g->topo);
+  free(g->topo_pos);
 }
 
-// --- Recursive DFS with Memoization ---
-long long count_paths(int u, int target_id) {
-  // 1. Check Memoization table
-  if (memo[u] != -1) {
-    return memo[u];
+// --- Path counting in reverse topological order ---
+// paths[u] = sum of paths[v] over edges u -> v, paths[target] = 1.
+// Only nodes between target and source in topo order need visiting.
+// paths must hold num_nodes zeroed counts.
+void count_paths(Graph *g, int source, int target, Count *paths) {
+  int from = g->topo_pos[target];
+  int to = g->topo_pos[source];
+  if (to > from || from >= g->num_sorted)
+    return;
+
+  count_set(&paths[target], 1);
+  int overflow = 0;
+  for (int i = from - 1; i >= to; i--) {
+    int u = g->topo[i];
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+      overflow |= count_add(&paths[u], &paths[g->target[e]]);
   }
+  count_overflow |= overflow;
+}
 
-  // 2. Base Case: Reached the target
-  if (u == target_id) {
-    return 1;
+// --- Levels for the parallel sweep ---
+// level = longest distance to a node outside the swept range, so all nodes
+// of a level only read nodes of lower levels and can run in parallel.
+typedef struct {
+  int num_levels;
+  int *start; // Level l is nodes[start[l] .. start[l+1]-1]
+  int *nodes;
+} Levels;
+
+void build_levels(Graph *g, int first_pos, int last_pos, Levels *lv) {
+  int n = last_pos - first_pos + 1;
+  int *level = malloc((n > 0 ? n : 1) * sizeof(int)); // Indexed by position
+  lv->num_levels = 0;
+
+  for (int i = last_pos; i >= first_pos; i--) {
+    int u = g->topo[i];
+    int l = 0;
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++) {
+      int p = g->topo_pos[g->target[e]];
+      if (p <= last_pos && level[p - first_pos] + 1 > l)
+        l = level[p - first_pos] + 1;
+    }
+    level[i - first_pos] = l;
+    if (l + 1 > lv->num_levels)
+      lv->num_levels = l + 1;
+  }
+
+  // Counting sort by level
+  lv->start = calloc(lv->num_levels + 1, sizeof(int));
+  lv->nodes = malloc((n > 0 ? n : 1) * sizeof(int));
+  for (int i = 0; i < n; i++)
+    lv->start[level[i] + 1]++;
+  for (int l = 0; l < lv->num_levels; l++)
+    lv->start[l + 1] += lv->start[l];
+  int *next = malloc((lv->num_levels + 1) * sizeof(int));
+  memcpy(next, lv->start, (lv->num_levels + 1) * sizeof(int));
+  for (int i = 0; i < n; i++)
+    lv->nodes[next[level[i]]++] = g->topo[first_pos + i];
+
+  free(next);
+  free(level);
+}
+
+void free_levels(Levels *lv) {
+  free(lv->start);
+  free(lv->nodes);
+}
+
+// --- Parallel sweep state ---
+// Main thread publishes a level, every thread claims chunks of its nodes,
+// barriers separate the levels. Pull-based: each node only writes its own
+// count, so no atomics on the counts.
+typedef struct {
+  Graph *g;
+  Count *paths;
+  Levels *levels;
+  int level;              // Level being processed
+  int finished;           // Set to stop the workers
+  atomic_int next;        // Next unclaimed node of the level
+  pthread_barrier_t go;   // Level published
+  pthread_barrier_t done; // Level complete
+} Sweep;
+
+typedef struct {
+  Sweep *sweep;
+  int overflow;
+} SweepWorker;
+
+static inline int sweep_node(Graph *g, Count *paths, int u) {
+  int overflow = 0;
+  for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+    overflow |= count_add(&paths[u], &paths[g->target[e]]);
+  return overflow;
+}
+
+void sweep_level(SweepWorker *w) {
+  Sweep *s = w->sweep;
+  int end = s->levels->start[s->level + 1];
+  int base = s->levels->start[s->level];
+  for (;;) {
+    int i = base + atomic_fetch_add(&s->next, SWEEP_CHUNK);
+    if (i >= end)
+      break;
+    int stop = i + SWEEP_CHUNK < end ? i + SWEEP_CHUNK : end;
+    for (; i < stop; i++)
+      w->overflow |= sweep_node(s->g, s->paths, s->levels->nodes[i]);
   }
+}
 
-  // 3. Recursive Step
-  long long total = 0;
-  for (int i = 0; i < adj_count[u]; i++) {
-    int v = adj[u][i];
-    total += count_paths(v, target_id);
+void *sweep_worker(void *arg) {
+  SweepWorker *w = arg;
+  Sweep *s = w->sweep;
+  for (;;) {
+    pthread_barrier_wait(&s->go);
+    if (s->finished)
+      break;
+    sweep_level(w);
+    pthread_barrier_wait(&s->done);
   }
+  return NULL;
+}
 
-  // 4. Store and return
-  memo[u] = total;
-  return total;
+double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
 }
 
-int main() {
-  char line[1024];
+// --- Parallel level-synchronous path counting ---
+// Same result as count_paths(). Levels under PARALLEL_MIN_NODES nodes run on
+// the main thread alone. With timing set, prints one line per level to
+// stderr.
+void count_paths_parallel(Graph *g, int source, int target, Count *paths,
+                          int num_threads, int timing) {
+  int from = g->topo_pos[target];
+  int to = g->topo_pos[source];
+  if (to > from || from >= g->num_sorted)
+    return;
+  count_set(&paths[target], 1);
+
+  Levels lv;
+  build_levels(g, to, from - 1, &lv);
+
+  Sweep s = {.g = g, .paths = paths, .levels = &lv};
+  pthread_barrier_init(&s.go, NULL, num_threads);
+  pthread_barrier_init(&s.done, NULL, num_threads);
+
+  pthread_t threads[MAX_THREADS];
+  SweepWorker workers[MAX_THREADS];
+  for (int t = 0; t < num_threads; t++) {
+    workers[t].sweep = &s;
+    workers[t].overflow = 0;
+  }
+  for (int t = 1; t < num_threads; t++)
+    pthread_create(&threads[t], NULL, sweep_worker, &workers[t]);
 
-  // Reset graph
-  num_devices = 0;
+  double total_ms = 0;
+  for (int l = 0; l < lv.num_levels; l++) {
+    double t0 = timing ? now_ms() : 0;
+    int size = lv.start[l + 1] - lv.start[l];
+    s.level = l;
+    if (num_threads == 1 || size < PARALLEL_MIN_NODES) {
+      for (int i = lv.start[l]; i < lv.start[l + 1]; i++)
+        workers[0].overflow |= sweep_node(g, paths, lv.nodes[i]);
+    } else {
+      atomic_store(&s.next, 0);
+      pthread_barrier_wait(&s.go);
+      sweep_level(&workers[0]);
+      pthread_barrier_wait(&s.done);
+    }
+    if (timing) {
+      double ms = now_ms() - t0;
+      total_ms += ms;
+      long long edges = 0;
+      for (int i = lv.start[l]; i < lv.start[l + 1]; i++)
+        edges += g->offset[lv.nodes[i] + 1] - g->offset[lv.nodes[i]];
+      fprintf(stderr, "Level %d: %d nodes, %lld edges, %.3f ms%s\n", l, size,
+              edges, ms, size < PARALLEL_MIN_NODES ? " (serial)" : "");
+    }
+  }
+  if (timing)
+    fprintf(stderr, "Sweep: %d levels, %d threads, %.3f ms\n", lv.num_levels,
+            num_threads, total_ms);
 
+  s.finished = 1;
+  pthread_barrier_wait(&s.go);
+  for (int t = 1; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+  for (int t = 0; t < num_threads; t++)
+    count_overflow |= workers[t].overflow;
+
+  pthread_barrier_destroy(&s.go);
+  pthread_barrier_destroy(&s.done);
+  free_levels(&lv);
+}
+
+int main(int argc, char **argv) {
+  char *line = NULL;
+  size_t line_cap = 0;
+
+  // Options: --parallel (all cores) or --threads N for the level-synchronous
+  // sweep, --timing for a per-level breakdown on stderr
+  long num_threads = 0; // 0: serial sweep
+  int timing = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--parallel") == 0)
+      num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+      num_threads = atol(argv[++i]);
+    else if (strcmp(argv[i], "--timing") == 0)
+      timing = 1;
+  }
+
+  PHASE_MARK("parse");
   // 1. Parse Input
-  while (fgets(line, sizeof(line), stdin)) {
+  while (getline(&line, &line_cap, stdin) != -1) {
     // Line format: "name: dest1 dest2 ..."
     // Replace ':' with space to simplify tokenization
     char *colon = strchr(line, ':');
@@ -90,34 +678,55 @@ int main() {
     int u = get_id(token);
 
     // Subsequent tokens are Destination Nodes
-    while ((token = strtok(NULL, " \t\n")) != NULL) {
-      int v = get_id(token);
-
-      // Add edge u -> v
-      if (adj_count[u] < MAX_NEIGHBORS) {
-        adj[u][adj_count[u]++] = v;
-      }
-    }
+    while ((token = strtok(NULL, " \t\n")) != NULL)
+      add_edge(u, get_id(token));
   }
+  free(line);
 
   // 2. Identify Start and End IDs
-  int start_id = -1, end_id = -1;
-  for (int i = 0; i < num_devices; i++) {
-    if (strcmp(map[i].name, "you") == 0)
-      start_id = i;
-    if (strcmp(map[i].name, "out") == 0)
-      end_id = i;
-  }
+  int start_id = interner_find(&names, "you");
+  int end_id = interner_find(&names, "out");
 
   if (start_id == -1 || end_id == -1) {
     printf("Error: Could not find 'you' or 'out' in the input.\n");
     return 1;
   }
 
-  // 3. Calculate Paths
-  long long total_paths = count_paths(start_id, end_id);
+  PHASE_MARK("build");
+  // 3. Build graph
+  Graph g;
+  if (build_graph(&g, names.count, &start_id, 1) != 0) {
+    fprintf(stderr, "Error: the devices reachable from 'you' contain a "
+                    "cycle.\n");
+    return 1;
+  }
+  free(edge_from);
+  free(edge_to);
+
+  PHASE_MARK("solve");
+  // 4. Calculate Paths
+  Count *paths = calloc(g.num_nodes, sizeof(Count));
+  if (num_threads > 0 || timing) {
+    if (num_threads < 1)
+      num_threads = 1;
+    if (num_threads > MAX_THREADS)
+      num_threads = MAX_THREADS;
+    count_paths_parallel(&g, start_id, end_id, paths, num_threads, timing);
+  } else {
+    count_paths(&g, start_id, end_id, paths);
+  }
+
+  printf("Total paths from 'you' to 'out': ");
+  count_print(&paths[start_id]);
+  printf("\n");
 
-  printf("Total paths from 'you' to 'out': %lld\n", total_paths);
+  if (count_overflow)
+    fprintf(stderr, "Warning: path counts overflowed; rebuild with "
+                    "-DCOUNT_MODE=COUNT_U128 or -DCOUNT_MODE=COUNT_BIG.\n");
 
+  for (int i = 0; i < g.num_nodes; i++)
+    count_free(&paths[i]);
+  free(paths);
+  free_graph(&g);
   return 0;
-}
\ No newline at end of file
+}
@@ -14,120 +14,931 @@
  * Total(A) = Paths(svr->dac) * Paths(dac->fft) * Paths(fft->out)
  * Total(B) = Paths(svr->fft) * Paths(fft->dac) * Paths(dac->out)
  * Grand Total = Total(A) + Total(B)
+ * * The same holds for any list of waypoints: the total is the sum over the
+ * allowed visiting orders of the product of segment counts. A bitmask DP over
+ * the set of waypoints visited so far sums all orders without listing them.
+ * Run as "reactor [--ordered] [waypoint ...]" to choose other waypoints;
+ * --ordered only counts paths that visit them in the given order.
  * * Algorithm:
- * Depth First Search (DFS) with Memoization is used to efficiently count paths
- * between any two given nodes.
+ * The graph is stored in CSR form, and the devices reachable from 'svr' and
+ * the waypoints are put in topological order with Kahn's algorithm (a cycle
+ * among the others is ignored). One iterative sweep in reverse topological
+ * order then gives, for every node, a vector of path counts to all waypoints
+ * and 'out' at once, so every segment count comes from the same traversal.
+ * * Parallel mode (--parallel / --threads N): nodes are grouped by level, the
+ * longest distance to the end of the swept range. A node only reads nodes
+ * of lower levels, so each level is split across a thread pool, with a
+ * barrier between levels; --timing prints the time spent on each level.
+ * * The count type is chosen at compile time with -DCOUNT_MODE=... (see
+ * "Path Count Type" below), since products of segment counts easily exceed
+ * 2^64 on dense graphs.
  */
 
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-// Configuration Constants
-// Increased limits to handle dense inputs often found in Advent of Code
-#define MAX_DEVICES 5000  // Maximum number of unique devices (nodes)
-#define MAX_NAME_LEN 16   // Maximum length of a device name string
-#define MAX_NEIGHBORS 100 // Maximum outgoing connections per device
+#include "../../common/phase.h"
 
-// Structure to map string names to integer IDs
+#define MAX_WAYPOINTS 16       // Bitmask DP uses 2^MAX_WAYPOINTS states
+#define MAX_LISTED_WAYPOINTS 3 // Print every order only up to 3! = 6 lines
+#define MAX_THREADS 64
+#define SWEEP_CHUNK 64          // Nodes claimed at once by a sweep thread
+#define PARALLEL_MIN_NODES 4096 // Smaller levels run on one thread
+
+/**
+ * Name Interner
+ * Maps device names to dense integer IDs in O(1) expected time.
+ * - All names are stored back to back in one growable string arena.
+ * - The lookup table uses open addressing (linear probing) and stores the
+ * full hash next to each ID, so strcmp only runs on a real hash match.
+ * - Device names are usually 3 characters; names of up to 4 bytes are packed
+ * directly into a uint32 key instead of being hashed byte by byte.
+ */
 typedef struct {
-  char name[MAX_NAME_LEN];
-  int id;
-} DeviceMap;
+  char *chars;         // String arena: NUL-terminated names, back to back
+  size_t chars_used;   // Bytes used in the arena
+  size_t chars_cap;    // Arena capacity in bytes
+  size_t *offset;      // offset[id] = start of the name of device id
+  int *slot_id;        // Hash table: device ID, or -1 for an empty slot
+  uint32_t *slot_hash; // Hash table: hash of the name in that slot
+  int capacity;        // Number of slots (power of two)
+  int count;           // Number of interned names
+} Interner;
 
-// Global Graph Storage
-// Using Adjacency List representation for memory efficiency on sparse graphs
-int adj[MAX_DEVICES][MAX_NEIGHBORS]; // Lists of neighbors for each node
-int adj_count[MAX_DEVICES];          // Number of neighbors for each node
-int num_devices = 0;                 // Current count of discovered devices
-DeviceMap map[MAX_DEVICES];          // Lookup table for name-to-ID mapping
+/**
+ * Hashes a name. Short names are packed into a uint32; longer ones use
+ * FNV-1a. Both go through a final avalanche so every bit of the result
+ * depends on every input byte.
+ */
+uint32_t hash_name(const char *name, size_t len) {
+  uint32_t h;
+  if (len <= 4) {
+    h = 0;
+    memcpy(&h, name, len);
+  } else {
+    h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+      h ^= (unsigned char)name[i];
+      h *= 16777619u;
+    }
+  }
+  // Final mix (MurmurHash3 fmix32)
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * Doubles the hash table and re-inserts every ID.
+ */
+void interner_grow(Interner *in) {
+  int old_capacity = in->capacity;
+  int *old_id = in->slot_id;
+  uint32_t *old_hash = in->slot_hash;
 
-// Memoization Table
-// Stores the result of count_paths(u, target) to avoid re-calculating
-// subproblems. Using 'unsigned long long' to prevent overflow as path counts
-// can be massive.
-unsigned long long memo[MAX_DEVICES];
+  in->capacity = old_capacity ? old_capacity * 2 : 1024;
+  in->slot_id = malloc(in->capacity * sizeof(int));
+  in->slot_hash = malloc(in->capacity * sizeof(uint32_t));
+  in->offset = realloc(in->offset, (in->capacity / 2) * sizeof(size_t));
+  for (int i = 0; i < in->capacity; i++)
+    in->slot_id[i] = -1;
+
+  int mask = in->capacity - 1;
+  for (int i = 0; i < old_capacity; i++) {
+    if (old_id[i] == -1)
+      continue;
+    int s = old_hash[i] & mask;
+    while (in->slot_id[s] != -1)
+      s = (s + 1) & mask;
+    in->slot_id[s] = old_id[i];
+    in->slot_hash[s] = old_hash[i];
+  }
+  free(old_id);
+  free(old_hash);
+}
+
+/**
+ * Finds the slot holding name, or the empty slot where it would go.
+ */
+int interner_probe(Interner *in, const char *name, uint32_t h) {
+  int mask = in->capacity - 1;
+  int s = h & mask;
+  while (in->slot_id[s] != -1) {
+    if (in->slot_hash[s] == h &&
+        strcmp(in->chars + in->offset[in->slot_id[s]], name) == 0)
+      return s;
+    s = (s + 1) & mask;
+  }
+  return s;
+}
+
+/**
+ * Returns the ID of an already interned name, or -1.
+ */
+int interner_find(Interner *in, const char *name) {
+  if (in->count == 0)
+    return -1;
+  size_t len = strlen(name);
+  return in->slot_id[interner_probe(in, name, hash_name(name, len))];
+}
+
+/**
+ * Returns the ID of name, interning it as the next free ID if it is new.
+ * *is_new is set when the name had not been seen before.
+ */
+int interner_add(Interner *in, const char *name, int *is_new) {
+  // Keep the load factor at or below 1/2
+  if (2 * (in->count + 1) > in->capacity)
+    interner_grow(in);
+
+  size_t len = strlen(name);
+  uint32_t h = hash_name(name, len);
+  int s = interner_probe(in, name, h);
+  *is_new = (in->slot_id[s] == -1);
+  if (!*is_new)
+    return in->slot_id[s];
+
+  // Copy the name into the string arena
+  if (in->chars_used + len + 1 > in->chars_cap) {
+    in->chars_cap = in->chars_cap ? in->chars_cap * 2 : 4096;
+    while (in->chars_used + len + 1 > in->chars_cap)
+      in->chars_cap *= 2;
+    in->chars = realloc(in->chars, in->chars_cap);
+  }
+  memcpy(in->chars + in->chars_used, name, len + 1);
+
+  int id = in->count++;
+  in->offset[id] = in->chars_used;
+  in->chars_used += len + 1;
+  in->slot_id[s] = id;
+  in->slot_hash[s] = h;
+  return id;
+}
+
+/**
+ * Returns the name of device id.
+ */
+const char *interner_name(Interner *in, int id) {
+  return in->chars + in->offset[id];
+}
+
+/**
+ * Path Count Type
+ * Path counts grow exponentially with the depth of the DAG, so the type used
+ * for them is chosen at compile time with -DCOUNT_MODE=...:
+ * - COUNT_U64  (default) 64-bit counts; overflow is detected and reported.
+ * - COUNT_U128 128-bit counts; overflow is detected and reported.
+ * - COUNT_MOD  counts modulo COUNT_MODULUS (default 1e9+7, must be < 2^63).
+ * - COUNT_BIG  arbitrary precision (base 2^32 limbs); never overflows.
+ * Every mode uses all-zero bytes for the value 0, so count arrays can be
+ * calloc'd or memset. The fixed-width adds are branch-free and return the
+ * carry, which keeps the inner loop of the sweep vectorisable (the 64-bit
+ * compare needs more than SSE2, e.g. gcc -O3 -march=native).
+ */
+#define COUNT_U64 0
+#define COUNT_U128 1
+#define COUNT_MOD 2
+#define COUNT_BIG 3
+
+#ifndef COUNT_MODE
+#define COUNT_MODE COUNT_U64
+#endif
+
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_MOD
+typedef unsigned long long Count;
+#elif COUNT_MODE == COUNT_U128
+typedef unsigned __int128 Count;
+#elif COUNT_MODE == COUNT_BIG
+typedef struct {
+  int len;        // Number of limbs in use (0 for the value 0)
+  int cap;        // Allocated limbs
+  uint32_t *limb; // Little-endian base 2^32 digits
+} Count;
+#else
+#error "Unknown COUNT_MODE"
+#endif
+
+#if COUNT_MODE == COUNT_MOD
+#ifndef COUNT_MODULUS
+#define COUNT_MODULUS 1000000007ULL
+#endif
+#endif
+
+int count_overflow = 0; // Set once any count has wrapped around
+
+#if COUNT_MODE == COUNT_BIG
+void big_reserve(Count *c, int cap) {
+  if (c->cap >= cap)
+    return;
+  c->cap = cap < 4 ? 4 : cap;
+  c->limb = realloc(c->limb, c->cap * sizeof(uint32_t));
+}
+#endif
+
+/**
+ * Sets c to a small value (0 or 1 in practice).
+ */
+static inline void count_set(Count *c, unsigned v) {
+#if COUNT_MODE == COUNT_BIG
+  c->len = 0;
+  if (v) {
+    big_reserve(c, 1);
+    c->limb[c->len++] = v;
+  }
+#else
+  *c = v;
+#endif
+}
+
+static inline int count_is_zero(const Count *c) {
+#if COUNT_MODE == COUNT_BIG
+  return c->len == 0;
+#else
+  return *c == 0;
+#endif
+}
+
+/**
+ * acc += x.
+ * @return 1 if a fixed-width count overflowed, 0 otherwise.
+ */
+static inline int count_add(Count *acc, const Count *x) {
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_U128
+  Count s = *acc + *x;
+  int carry = s < *acc;
+  *acc = s;
+  return carry;
+#elif COUNT_MODE == COUNT_MOD
+  Count s = *acc + *x;
+  *acc = s >= COUNT_MODULUS ? s - COUNT_MODULUS : s;
+  return 0;
+#else
+  if (x->len == 0)
+    return 0;
+  int len = acc->len > x->len ? acc->len : x->len;
+  big_reserve(acc, len + 1);
+  uint64_t carry = 0;
+  for (int i = 0; i < len; i++) {
+    uint64_t s = carry;
+    if (i < acc->len)
+      s += acc->limb[i];
+    if (i < x->len)
+      s += x->limb[i];
+    acc->limb[i] = (uint32_t)s;
+    carry = s >> 32;
+  }
+  acc->len = len;
+  if (carry)
+    acc->limb[acc->len++] = (uint32_t)carry;
+  return 0;
+#endif
+}
+
+/**
+ * out = a * b. out must not alias a or b.
+ * @return 1 if a fixed-width count overflowed, 0 otherwise.
+ */
+static inline int count_mul(Count *out, const Count *a, const Count *b) {
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_U128
+  return __builtin_mul_overflow(*a, *b, out);
+#elif COUNT_MODE == COUNT_MOD
+  *out = (unsigned long long)((unsigned __int128)*a * *b % COUNT_MODULUS);
+  return 0;
+#else
+  out->len = 0;
+  if (a->len == 0 || b->len == 0)
+    return 0;
+  int len = a->len + b->len;
+  big_reserve(out, len);
+  memset(out->limb, 0, len * sizeof(uint32_t));
+  for (int i = 0; i < a->len; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; j < b->len; j++) {
+      uint64_t t = (uint64_t)a->limb[i] * b->limb[j] + out->limb[i + j] + carry;
+      out->limb[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    out->limb[i + b->len] = (uint32_t)carry;
+  }
+  out->len = len;
+  while (out->len > 0 && out->limb[out->len - 1] == 0)
+    out->len--;
+  return 0;
+#endif
+}
+
+/**
+ * Releases the storage of a count (only the bignum mode owns any).
+ */
+static inline void count_free(Count *c) {
+#if COUNT_MODE == COUNT_BIG
+  free(c->limb);
+  c->limb = NULL;
+  c->len = c->cap = 0;
+#else
+  (void)c;
+#endif
+}
+
+/**
+ * Prints a count in decimal to stdout.
+ */
+void count_print(const Count *c) {
+#if COUNT_MODE == COUNT_U64 || COUNT_MODE == COUNT_MOD
+  printf("%llu", *c);
+#else
+  // Split into base 10^9 chunks, least significant first
+#if COUNT_MODE == COUNT_U128
+  Count v = *c;
+  uint32_t chunk[5];
+  int n = 0;
+  do {
+    chunk[n++] = (uint32_t)(v % 1000000000u);
+    v /= 1000000000u;
+  } while (v);
+#else
+  int len = c->len;
+  uint32_t *work = malloc((len + 1) * sizeof(uint32_t));
+  uint32_t *chunk = malloc((len * 10 / 9 + 2) * sizeof(uint32_t));
+  memcpy(work, c->limb, len * sizeof(uint32_t));
+  int n = 0;
+  do {
+    uint64_t rem = 0;
+    for (int i = len - 1; i >= 0; i--) {
+      uint64_t cur = (rem << 32) | work[i];
+      work[i] = (uint32_t)(cur / 1000000000u);
+      rem = cur % 1000000000u;
+    }
+    chunk[n++] = (uint32_t)rem;
+    while (len > 0 && work[len - 1] == 0)
+      len--;
+  } while (len > 0);
+#endif
+  printf("%u", chunk[n - 1]);
+  for (int i = n - 2; i >= 0; i--)
+    printf("%09u", chunk[i]);
+#if COUNT_MODE == COUNT_BIG
+  free(work);
+  free(chunk);
+#endif
+#endif
+}
+
+/**
+ * Graph in Compressed Sparse Row (CSR) form.
+ * The out-neighbours of node u are target[offset[u] .. offset[u+1]-1], so the
+ * whole graph is two flat arrays with no per-node limit on out-degree.
+ * topo[] lists the nodes reachable from the sources in topological order
+ * (edges only go forward), then the others, and topo_pos[u] is the position
+ * of u in that list.
+ */
+typedef struct {
+  int num_nodes;
+  int num_edges;
+  int *offset;    // num_nodes + 1 entries
+  int *target;    // num_edges entries
+  int *topo;      // Topological order of the reached nodes, then the rest
+  int *topo_pos;  // Inverse of topo
+  int num_sorted; // Number of reached nodes, at the start of topo
+} Graph;
+
+// Edge list collected while parsing, turned into CSR by build_graph()
+int *edge_from = NULL;
+int *edge_to = NULL;
+int num_edges = 0;
+int edge_capacity = 0;
+
+Interner names; // Lookup table for name-to-ID mapping
 
 /**
  * Gets the integer ID for a device name.
- * If the device is new, assigns a new ID and initializes it.
+ * If the device is new, assigns the next free ID.
  * * @param name The string name of the device (e.g., "aaa").
  * @return The integer ID associated with the name.
  */
 int get_id(char *name) {
-  // Linear search for existing ID (sufficient for N=5000)
-  for (int i = 0; i < num_devices; i++) {
-    if (strcmp(map[i].name, name) == 0) {
-      return i;
+  int is_new;
+  return interner_add(&names, name, &is_new);
+}
+
+/**
+ * Appends the directed edge u -> v to the edge list.
+ */
+void add_edge(int u, int v) {
+  if (num_edges == edge_capacity) {
+    edge_capacity = edge_capacity ? edge_capacity * 2 : 1024;
+    edge_from = realloc(edge_from, edge_capacity * sizeof(int));
+    edge_to = realloc(edge_to, edge_capacity * sizeof(int));
+  }
+  edge_from[num_edges] = u;
+  edge_to[num_edges] = v;
+  num_edges++;
+}
+
+/**
+ * Builds the CSR graph from the edge list in two passes (count out-degrees,
+ * then place each edge), followed by Kahn's algorithm for the topological
+ * order of the nodes reachable from the sources. No edge leaves that set, so
+ * the sweeps never read outside it, and a cycle elsewhere in the file is
+ * harmless.
+ * @return 0 on success, -1 if the reachable nodes contain a cycle.
+ */
+int build_graph(Graph *g, int num_nodes, const int *sources,
+                int num_sources) {
+  g->num_nodes = num_nodes;
+  g->num_edges = num_edges;
+  g->offset = calloc(num_nodes + 1, sizeof(int));
+  g->target = malloc((num_edges + 1) * sizeof(int));
+  g->topo = malloc((num_nodes + 1) * sizeof(int));
+  g->topo_pos = malloc((num_nodes + 1) * sizeof(int));
+
+  // Pass 1: out-degrees, then prefix sums give each node's first slot
+  for (int e = 0; e < num_edges; e++)
+    g->offset[edge_from[e] + 1]++;
+  for (int u = 0; u < num_nodes; u++)
+    g->offset[u + 1] += g->offset[u];
+
+  // Pass 2: place each edge at its source's next free slot
+  int *next = malloc((num_nodes + 1) * sizeof(int));
+  memcpy(next, g->offset, num_nodes * sizeof(int));
+  for (int e = 0; e < num_edges; e++)
+    g->target[next[edge_from[e]]++] = edge_to[e];
+
+  // Reachable set: depth-first from the sources, topo[] doubles as the stack
+  char *reached = calloc(num_nodes + 1, 1);
+  int num_reached = 0, top = 0;
+  for (int i = 0; i < num_sources; i++)
+    if (!reached[sources[i]]) {
+      reached[sources[i]] = 1;
+      g->topo[top++] = sources[i];
+    }
+  while (top > 0) {
+    int u = g->topo[--top];
+    num_reached++;
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+      if (!reached[g->target[e]]) {
+        reached[g->target[e]] = 1;
+        g->topo[top++] = g->target[e];
+      }
+  }
+
+  // Kahn's algorithm on the reached nodes: repeatedly take a node with no
+  // remaining in-edges. topo[] doubles as the queue.
+  int *in_degree = next; // Reuse the buffer
+  memset(in_degree, 0, num_nodes * sizeof(int));
+  for (int u = 0; u < num_nodes; u++)
+    if (reached[u])
+      for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+        in_degree[g->target[e]]++;
+
+  int head = 0, tail = 0;
+  for (int u = 0; u < num_nodes; u++)
+    if (reached[u] && in_degree[u] == 0)
+      g->topo[tail++] = u;
+  while (head < tail) {
+    int u = g->topo[head++];
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++)
+      if (--in_degree[g->target[e]] == 0)
+        g->topo[tail++] = g->target[e];
+  }
+  free(in_degree);
+
+  // The unreached nodes go last, in no particular order
+  int sorted = tail;
+  for (int u = 0; u < num_nodes; u++)
+    if (!reached[u])
+      g->topo[tail++] = u;
+  free(reached);
+  if (sorted != num_reached)
+    return -1;
+
+  g->num_sorted = sorted;
+  for (int i = 0; i < tail; i++)
+    g->topo_pos[g->topo[i]] = i;
+  return 0;
+}
+
+void free_graph(Graph *g) {
+  free(g->offset);
+  free(g->target);
+  free(g->topo);
+  free(g->topo_pos);
+}
+
+/**
+ * Computes the row of path counts of node u from the rows of its
+ * successors (pull-based: only row u is written, so no atomics are needed
+ * when different threads handle different nodes).
+ * @return 1 if a count overflowed.
+ */
+static inline int sweep_node(Graph *g, const int *targets, int k, Count *paths,
+                             int u) {
+  int overflow = 0;
+  Count *row = paths + (size_t)u * k;
+  for (int e = g->offset[u]; e < g->offset[u + 1]; e++) {
+    const Count *next = paths + (size_t)g->target[e] * k;
+    for (int t = 0; t < k; t++)
+      overflow |= count_add(&row[t], &next[t]);
+  }
+  for (int t = 0; t < k; t++)
+    if (targets[t] == u)
+      count_set(&row[t], 1);
+  return overflow;
+}
+
+/**
+ * Returns the topological position of the last reached target (a target
+ * that wasn't reached has no paths to it to count).
+ */
+int last_target_pos(Graph *g, const int *targets, int k) {
+  int last_pos = -1;
+  for (int t = 0; t < k; t++) {
+    int pos = g->topo_pos[targets[t]];
+    if (pos < g->num_sorted && pos > last_pos)
+      last_pos = pos;
+  }
+  return last_pos;
+}
+
+/**
+ * Counts paths from every node to several targets at once, with a single
+ * sweep in reverse topological order.
+ * * paths[u * num_targets + t] is the number of paths from u to targets[t]:
+ * the sum of the same entry over the out-edges u -> v, with 1 on the
+ * target itself. Each edge is visited once per sweep rather than once per
+ * (source, target) pair.
+ * * Nodes after the last target in topological order can't reach any target
+ * and stay 0; nodes before first_pos are not needed and are skipped.
+ * * @param paths Output matrix of num_nodes * num_targets zeroed entries.
+ */
+void count_paths_multi(Graph *g, const int *targets, int num_targets,
+                       int first_pos, Count *paths) {
+  int last_pos = last_target_pos(g, targets, num_targets);
+  int overflow = 0;
+  for (int i = last_pos; i >= first_pos; i--)
+    overflow |= sweep_node(g, targets, num_targets, paths, g->topo[i]);
+  count_overflow |= overflow;
+}
+
+/**
+ * Nodes grouped into levels for the parallel sweep.
+ * The level of a node is its longest distance (in edges) to a node outside
+ * the swept range, so every successor of a level-l node is in a lower level
+ * or already final. All nodes of one level can then be computed at once.
+ */
+typedef struct {
+  int num_levels;
+  int *start; // Level l is nodes[start[l] .. start[l+1]-1]
+  int *nodes;
+} Levels;
+
+/**
+ * Levels the nodes at topological positions first_pos..last_pos, then
+ * buckets them by level with a counting sort.
+ */
+void build_levels(Graph *g, int first_pos, int last_pos, Levels *lv) {
+  int n = last_pos - first_pos + 1;
+  int *level = malloc((n > 0 ? n : 1) * sizeof(int)); // Indexed by position
+  lv->num_levels = 0;
+
+  for (int i = last_pos; i >= first_pos; i--) {
+    int u = g->topo[i];
+    int l = 0;
+    for (int e = g->offset[u]; e < g->offset[u + 1]; e++) {
+      int p = g->topo_pos[g->target[e]];
+      if (p <= last_pos && level[p - first_pos] + 1 > l)
+        l = level[p - first_pos] + 1;
     }
+    level[i - first_pos] = l;
+    if (l + 1 > lv->num_levels)
+      lv->num_levels = l + 1;
+  }
+
+  lv->start = calloc(lv->num_levels + 1, sizeof(int));
+  lv->nodes = malloc((n > 0 ? n : 1) * sizeof(int));
+  for (int i = 0; i < n; i++)
+    lv->start[level[i] + 1]++;
+  for (int l = 0; l < lv->num_levels; l++)
+    lv->start[l + 1] += lv->start[l];
+  int *next = malloc((lv->num_levels + 1) * sizeof(int));
+  memcpy(next, lv->start, (lv->num_levels + 1) * sizeof(int));
+  for (int i = 0; i < n; i++)
+    lv->nodes[next[level[i]]++] = g->topo[first_pos + i];
+
+  free(next);
+  free(level);
+}
+
+void free_levels(Levels *lv) {
+  free(lv->start);
+  free(lv->nodes);
+}
+
+/**
+ * Shared state of a parallel level-synchronous sweep.
+ * The main thread publishes a level, all threads claim chunks of its nodes
+ * through an atomic counter, and two barriers separate the levels.
+ */
+typedef struct {
+  Graph *g;
+  const int *targets;
+  int num_targets;
+  Count *paths;
+  Levels *levels;
+  int level;              // Level being processed
+  int finished;           // Set to stop the workers
+  atomic_int next;        // Next unclaimed node of the level
+  pthread_barrier_t go;   // Level published
+  pthread_barrier_t done; // Level complete
+} Sweep;
+
+typedef struct {
+  Sweep *sweep;
+  int overflow;
+} SweepWorker;
+
+/**
+ * Processes chunks of the current level until none are left.
+ */
+void sweep_level(SweepWorker *w) {
+  Sweep *s = w->sweep;
+  int end = s->levels->start[s->level + 1];
+  int base = s->levels->start[s->level];
+  for (;;) {
+    int i = base + atomic_fetch_add(&s->next, SWEEP_CHUNK);
+    if (i >= end)
+      break;
+    int stop = i + SWEEP_CHUNK < end ? i + SWEEP_CHUNK : end;
+    for (; i < stop; i++)
+      w->overflow |= sweep_node(s->g, s->targets, s->num_targets, s->paths,
+                                s->levels->nodes[i]);
   }
+}
 
-  // Safety check for array bounds
-  if (num_devices >= MAX_DEVICES) {
-    fprintf(stderr,
-            "Error: MAX_DEVICES limit reached! Increase the constant.\n");
-    exit(1);
+void *sweep_worker(void *arg) {
+  SweepWorker *w = arg;
+  Sweep *s = w->sweep;
+  for (;;) {
+    pthread_barrier_wait(&s->go);
+    if (s->finished)
+      break;
+    sweep_level(w);
+    pthread_barrier_wait(&s->done);
   }
+  return NULL;
+}
 
-  // Register new device
-  strcpy(map[num_devices].name, name);
-  map[num_devices].id = num_devices;
-  adj_count[num_devices] = 0;
-  return num_devices++;
+double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
 }
 
 /**
- * Resets the memoization table.
- * Must be called before starting a new path counting segment (e.g., changing
- * the target). Sets all entries to -1 (represented as max unsigned value).
+ * Parallel version of count_paths_multi().
+ * Levels are processed from 0 upwards. Small levels (under
+ * PARALLEL_MIN_NODES nodes) run on the main thread alone, larger ones are
+ * split across the pool. With timing set, prints one line per level with
+ * its size and wall time to stderr.
  */
-void reset_memo() {
-  // 0xFF represents all bits set to 1. In two's complement, this is -1.
-  // For unsigned types, this is the maximum possible value, acting as a
-  // sentinel.
-  memset(memo, 0xFF, sizeof(memo));
+void count_paths_parallel(Graph *g, const int *targets, int num_targets,
+                          int first_pos, Count *paths, int num_threads,
+                          int timing) {
+  Levels lv;
+  build_levels(g, first_pos, last_target_pos(g, targets, num_targets), &lv);
+
+  Sweep s = {.g = g,
+             .targets = targets,
+             .num_targets = num_targets,
+             .paths = paths,
+             .levels = &lv};
+  pthread_barrier_init(&s.go, NULL, num_threads);
+  pthread_barrier_init(&s.done, NULL, num_threads);
+
+  pthread_t threads[MAX_THREADS];
+  SweepWorker workers[MAX_THREADS];
+  for (int t = 0; t < num_threads; t++) {
+    workers[t].sweep = &s;
+    workers[t].overflow = 0;
+  }
+  for (int t = 1; t < num_threads; t++)
+    pthread_create(&threads[t], NULL, sweep_worker, &workers[t]);
+
+  double total_ms = 0;
+  for (int l = 0; l < lv.num_levels; l++) {
+    double t0 = timing ? now_ms() : 0;
+    int size = lv.start[l + 1] - lv.start[l];
+    s.level = l;
+    if (num_threads == 1 || size < PARALLEL_MIN_NODES) {
+      for (int i = lv.start[l]; i < lv.start[l + 1]; i++)
+        workers[0].overflow |=
+            sweep_node(g, targets, num_targets, paths, lv.nodes[i]);
+    } else {
+      atomic_store(&s.next, 0);
+      pthread_barrier_wait(&s.go);
+      sweep_level(&workers[0]);
+      pthread_barrier_wait(&s.done);
+    }
+    if (timing) {
+      double ms = now_ms() - t0;
+      total_ms += ms;
+      long long edges = 0;
+      for (int i = lv.start[l]; i < lv.start[l + 1]; i++)
+        edges += g->offset[lv.nodes[i] + 1] - g->offset[lv.nodes[i]];
+      fprintf(stderr, "Level %d: %d nodes, %lld edges, %.3f ms%s\n", l, size,
+              edges, ms, size < PARALLEL_MIN_NODES ? " (serial)" : "");
+    }
+  }
+  if (timing)
+    fprintf(stderr, "Sweep: %d levels, %d threads, %.3f ms\n", lv.num_levels,
+            num_threads, total_ms);
+
+  s.finished = 1;
+  pthread_barrier_wait(&s.go);
+  for (int t = 1; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+  for (int t = 0; t < num_threads; t++)
+    count_overflow |= workers[t].overflow;
+
+  pthread_barrier_destroy(&s.go);
+  pthread_barrier_destroy(&s.done);
+  free_levels(&lv);
 }
 
 /**
- * Recursive Depth First Search (DFS) with Memoization.
- * Counts all distinct paths from node u to target_id.
- * * @param u The current node ID.
- * @param target_id The destination node ID.
- * @return The number of valid paths.
+ * Counts paths source -> ... -> out that visit every waypoint, using the
+ * segment counts from count_paths_multi() (waypoint j is target j, 'out' is
+ * target num_way).
+ * * Bitmask DP: dp[mask][last] is the number of paths from the source that
+ * have visited exactly the waypoints in mask, in some allowed order, and
+ * currently stand on waypoint 'last'. Extending to waypoint n multiplies by
+ * Paths(last -> n). If ordered is set, the only allowed next waypoint is the
+ * one at list position popcount(mask), so the list order is enforced.
+ * * In a DAG a path can't revisit a node, so every path visits the waypoints
+ * in exactly one order and the orders are disjoint: summing over them never
+ * double counts.
  */
-unsigned long long count_paths(int u, int target_id) {
-  // 1. Check Memoization Table
-  // If value is not the sentinel (max ULL), return the cached result.
-  if (memo[u] != 0xFFFFFFFFFFFFFFFFULL) {
-    return memo[u];
+void count_via_waypoints(const Count *paths, int source, const int *way,
+                         int num_way, int ordered, Count *total) {
+  int k = num_way + 1; // Waypoints plus 'out'
+  if (num_way == 0) {
+    count_add(total, &paths[(size_t)source * k + num_way]);
+    return;
   }
 
-  // 2. Base Case
-  // We reached the target node. This counts as 1 valid path.
-  if (u == target_id) {
-    return 1;
+  int full = (1 << num_way) - 1;
+  size_t states = (size_t)(full + 1) * num_way;
+  Count *dp = calloc(states, sizeof(Count));
+  Count step = {0};
+
+  for (int j = 0; j < num_way; j++)
+    if (!ordered || j == 0)
+      count_add(&dp[(1 << j) * num_way + j], &paths[(size_t)source * k + j]);
+
+  for (int mask = 1; mask < full; mask++) {
+    for (int last = 0; last < num_way; last++) {
+      const Count *ways = &dp[mask * num_way + last];
+      if (count_is_zero(ways))
+        continue;
+      const Count *from = paths + (size_t)way[last] * k;
+      for (int n = 0; n < num_way; n++) {
+        if (mask & (1 << n))
+          continue;
+        if (ordered && n != __builtin_popcount(mask))
+          continue;
+        count_overflow |= count_mul(&step, ways, &from[n]);
+        count_overflow |=
+            count_add(&dp[(mask | (1 << n)) * num_way + n], &step);
+      }
+    }
+  }
+
+  for (int last = 0; last < num_way; last++) {
+    count_overflow |= count_mul(&step, &dp[full * num_way + last],
+                                &paths[(size_t)way[last] * k + num_way]);
+    count_overflow |= count_add(total, &step);
+  }
+
+  for (size_t s = 0; s < states; s++)
+    count_free(&dp[s]);
+  count_free(&step);
+  free(dp);
+}
+
+/**
+ * Counts paths that visit the waypoints in exactly the given order, as the
+ * product of the segment counts along it.
+ */
+void count_in_order(const Count *paths, int source, const int *way,
+                    const int *order, int num_way, Count *product) {
+  int k = num_way + 1;
+  Count prev = {0};
+  count_set(product, 1);
+  int at = source;
+  for (int j = 0; j <= num_way; j++) {
+    int t = (j < num_way) ? order[j] : num_way;
+    Count tmp = prev; // Swap, so the product never aliases its input
+    prev = *product;
+    *product = tmp;
+    count_overflow |= count_mul(product, &prev, &paths[(size_t)at * k + t]);
+    if (j < num_way)
+      at = way[t];
   }
+  count_free(&prev);
+}
 
-  // 3. Recursive Step
-  // Sum the paths from all neighbors to the target.
-  unsigned long long total = 0;
-  for (int i = 0; i < adj_count[u]; i++) {
-    int v = adj[u][i];
-    total += count_paths(v, target_id);
+/**
+ * Rearranges a into the next lexicographic permutation.
+ * @return 0 once a was the last permutation.
+ */
+int next_permutation(int *a, int n) {
+  int i = n - 2;
+  while (i >= 0 && a[i] >= a[i + 1])
+    i--;
+  if (i < 0)
+    return 0;
+  int j = n - 1;
+  while (a[j] <= a[i])
+    j--;
+  int tmp = a[i];
+  a[i] = a[j];
+  a[j] = tmp;
+  for (int l = i + 1, r = n - 1; l < r; l++, r--) {
+    tmp = a[l];
+    a[l] = a[r];
+    a[r] = tmp;
   }
+  return 1;
+}
 
-  // 4. Store Result
-  memo[u] = total;
-  return total;
+/**
+ * Prints the path count for one waypoint order, e.g.
+ * "Paths (svr->dac->fft->out): N".
+ */
+void print_order(const Count *paths, int source, const int *way,
+                 const int *order, int num_way) {
+  Count product = {0};
+  count_in_order(paths, source, way, order, num_way, &product);
+  printf("Paths (%s", interner_name(&names, source));
+  for (int j = 0; j < num_way; j++)
+    printf("->%s", interner_name(&names, way[order[j]]));
+  printf("->out): ");
+  count_print(&product);
+  printf("\n");
+  count_free(&product);
 }
 
-int main() {
-  char line[4096];
-  num_devices = 0;
+int main(int argc, char **argv) {
+  char *line = NULL;
+  size_t line_cap = 0;
+
+  // --- 0. Options ---
+  // Usage: reactor [--ordered] [--parallel | --threads N] [--timing]
+  //                [waypoint ...] < input.txt
+  // Without waypoints the puzzle's 'dac' and 'fft' are used, in any order.
+  // --parallel runs the level-synchronous sweep on all cores (--threads N on
+  // N threads); --timing also uses it and prints a per-level timing
+  // breakdown to stderr.
+  const char *way_names[MAX_WAYPOINTS];
+  int num_way = 0;
+  int ordered = 0;
+  long num_threads = 0; // 0: serial sweep
+  int timing = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--ordered") == 0) {
+      ordered = 1;
+    } else if (strcmp(argv[i], "--parallel") == 0) {
+      num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      num_threads = atol(argv[++i]);
+    } else if (strcmp(argv[i], "--timing") == 0) {
+      timing = 1;
+    } else if (num_way == MAX_WAYPOINTS) {
+      fprintf(stderr, "Error: at most %d waypoints are supported.\n",
+              MAX_WAYPOINTS);
+      return 1;
+    } else {
+      way_names[num_way++] = argv[i];
+    }
+  }
+  if (num_way == 0) {
+    way_names[num_way++] = "dac";
+    way_names[num_way++] = "fft";
+  }
 
+  PHASE_MARK("parse");
   // --- 1. Parse Input Graph ---
   // Reads line by line, format: "source: dest1 dest2 ..."
-  while (fgets(line, sizeof(line), stdin)) {
+  while (getline(&line, &line_cap, stdin) != -1) {
     // Pre-cleaning: replace ':' with space for easier tokenization
     char *colon = strchr(line, ':');
     if (!colon)
@@ -141,78 +952,108 @@ int main() {
     int u = get_id(token); // Parse Source Node
 
     // Parse Destination Nodes
-    while ((token = strtok(NULL, " \t\n")) != NULL) {
-      int v = get_id(token);
-
-      if (adj_count[u] >= MAX_NEIGHBORS) {
-        fprintf(stderr,
-                "Error: MAX_NEIGHBORS limit reached for device '%s'! Increase "
-                "the constant.\n",
-                map[u].name);
-        exit(1);
-      }
-      adj[u][adj_count[u]++] = v; // Add Directed Edge u -> v
-    }
+    while ((token = strtok(NULL, " \t\n")) != NULL)
+      add_edge(u, get_id(token)); // Add Directed Edge u -> v
   }
+  free(line);
 
   // --- 2. Identify Critical Nodes ---
-  // We need the IDs for the start, end, and the two required intermediate
-  // nodes.
-  int id_svr = -1, id_out = -1, id_dac = -1, id_fft = -1;
-
-  for (int i = 0; i < num_devices; i++) {
-    if (strcmp(map[i].name, "svr") == 0)
-      id_svr = i;
-    if (strcmp(map[i].name, "out") == 0)
-      id_out = i;
-    if (strcmp(map[i].name, "dac") == 0)
-      id_dac = i;
-    if (strcmp(map[i].name, "fft") == 0)
-      id_fft = i;
-  }
-
-  if (id_svr == -1 || id_out == -1 || id_dac == -1 || id_fft == -1) {
-    printf(
-        "Error: Missing one of the required devices (svr, out, dac, fft).\n");
-    return 1;
+  // We need the IDs for the start, end, and the required intermediate nodes.
+  // The targets of the sweep are the waypoints followed by 'out'.
+  int id_svr = interner_find(&names, "svr");
+  int id_out = interner_find(&names, "out");
+  int targets[MAX_WAYPOINTS + 1];
+  int missing = (id_svr == -1 || id_out == -1);
+  for (int j = 0; j < num_way; j++) {
+    targets[j] = interner_find(&names, way_names[j]);
+    if (targets[j] == -1) {
+      printf("Error: Unknown waypoint device '%s'.\n", way_names[j]);
+      missing = 1;
+    }
+    for (int i = 0; i < j; i++)
+      if (targets[j] != -1 && targets[i] == targets[j]) {
+        printf("Error: Waypoint '%s' is listed twice.\n", way_names[j]);
+        missing = 1;
+      }
   }
+  targets[num_way] = id_out;
 
-  // --- 3. Calculate Sequence A: svr -> dac -> fft -> out ---
-  // Since we reuse the DFS function, we must reset memoization between segments
-  // because the 'target_id' changes.
-
-  reset_memo();
-  unsigned long long p1 = count_paths(id_svr, id_dac); // Segment 1
-
-  reset_memo();
-  unsigned long long p2 = count_paths(id_dac, id_fft); // Segment 2
-
-  reset_memo();
-  unsigned long long p3 = count_paths(id_fft, id_out); // Segment 3
-
-  // Paths combine multiplicatively in series
-  unsigned long long count_sequence_A = p1 * p2 * p3;
+  if (missing) {
+    printf("Error: Missing one of the required devices (svr, out or a "
+           "waypoint).\n");
+    return 1;
+  }
 
-  // --- 4. Calculate Sequence B: svr -> fft -> dac -> out ---
+  PHASE_MARK("build");
+  // --- 3. Build the CSR graph and its topological order ---
+  // Segments start at 'svr' or at a waypoint, so only the devices reachable
+  // from those matter
+  Graph g;
+  int sources[MAX_WAYPOINTS + 1];
+  sources[0] = id_svr;
+  memcpy(sources + 1, targets, num_way * sizeof(int));
+  if (build_graph(&g, names.count, sources, num_way + 1) != 0) {
+    fprintf(stderr, "Error: the devices reachable from 'svr' and the "
+                    "waypoints contain a cycle.\n");
+    return 1;
+  }
+  free(edge_from);
+  free(edge_to);
 
-  reset_memo();
-  unsigned long long q1 = count_paths(id_svr, id_fft); // Segment 1
+  PHASE_MARK("solve");
+  // --- 4. One sweep: path counts from every node to every target ---
+  // Segments start at 'svr' or at a waypoint, so the sweep can stop at the
+  // earliest of those in topological order.
+  int first_pos = g.topo_pos[id_svr];
+  for (int j = 0; j < num_way; j++)
+    if (g.topo_pos[targets[j]] < first_pos)
+      first_pos = g.topo_pos[targets[j]];
 
-  reset_memo();
-  unsigned long long q2 = count_paths(id_fft, id_dac); // Segment 2
+  int k = num_way + 1;
+  size_t num_counts = (size_t)g.num_nodes * k;
+  Count *paths = calloc(num_counts, sizeof(Count));
+  if (num_threads > 0 || timing) {
+    if (num_threads < 1)
+      num_threads = 1;
+    if (num_threads > MAX_THREADS)
+      num_threads = MAX_THREADS;
+    count_paths_parallel(&g, targets, k, first_pos, paths, num_threads,
+                         timing);
+  } else {
+    count_paths_multi(&g, targets, k, first_pos, paths);
+  }
 
-  reset_memo();
-  unsigned long long q3 = count_paths(id_dac, id_out); // Segment 3
+  // --- 5. Per-order breakdown ---
+  // Each order is a product of segment counts, e.g.
+  // Paths(svr->dac) * Paths(dac->fft) * Paths(fft->out).
+  int order[MAX_WAYPOINTS];
+  for (int j = 0; j < num_way; j++)
+    order[j] = j;
+  if (ordered) {
+    print_order(paths, id_svr, targets, order, num_way);
+  } else if (num_way <= MAX_LISTED_WAYPOINTS) {
+    do {
+      print_order(paths, id_svr, targets, order, num_way);
+    } while (next_permutation(order, num_way));
+  }
 
-  unsigned long long count_sequence_B = q1 * q2 * q3;
+  // --- 6. Total ---
+  // Summed over all allowed orders by the bitmask DP
+  Count total = {0};
+  count_via_waypoints(paths, id_svr, targets, num_way, ordered, &total);
 
-  // --- 5. Total ---
-  // Sequences A and B represent disjoint sets of paths in a DAG
-  unsigned long long total = count_sequence_A + count_sequence_B;
+  printf("Total valid paths: ");
+  count_print(&total);
+  printf("\n");
 
-  printf("Paths (svr->dac->fft->out): %llu\n", count_sequence_A);
-  printf("Paths (svr->fft->dac->out): %llu\n", count_sequence_B);
-  printf("Total valid paths: %llu\n", total);
+  if (count_overflow)
+    fprintf(stderr, "Warning: path counts overflowed; rebuild with "
+                    "-DCOUNT_MODE=COUNT_U128 or -DCOUNT_MODE=COUNT_BIG.\n");
 
+  count_free(&total);
+  for (size_t i = 0; i < num_counts; i++)
+    count_free(&paths[i]);
+  free(paths);
+  free_graph(&g);
   return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 
+#include "../../common/phase.h" // Memory report with -DAOC_ALLOCS
+
 // Function to check if a number is composed of a sequence repeated twice
 // Returns 1 if invalid (meaning it fits the puzzle description), 0 otherwise.
 int is_invalid_id(long long n) {
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h" // Memory report with -DAOC_ALLOCS
+
 // Function to check if a number is composed of any sequence repeated at least
 // twice
 int is_recursive_pattern(long long n) {
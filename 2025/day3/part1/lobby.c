@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h" // Memory report with -DAOC_ALLOCS
+
 int main() {
   char line[4096]; // Buffer to hold one line of input
   long long total_output = 0;
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_SIZE 2048 // Maximum grid size assumption
 
 char grid[MAX_SIZE][MAX_SIZE];
@@ -8,6 +10,7 @@ int rows = 0;
 int cols = 0;
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Read the input into the grid
   while (scanf("%s", grid[rows]) == 1) {
     rows++;
@@ -18,6 +21,7 @@ int main() {
     cols = strlen(grid[0]);
   }
 
+  PHASE_MARK("solve");
   int accessible_count = 0;
 
   // 2. Iterate through every cell
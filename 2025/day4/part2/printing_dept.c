@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_SIZE 2048 // Maximum expected grid size
 
 char grid[MAX_SIZE][MAX_SIZE];
@@ -10,6 +12,7 @@ int rows = 0;
 int cols = 0;
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Read the input
   while (scanf("%s", grid[rows]) == 1) {
     rows++;
@@ -17,6 +20,7 @@ int main() {
   if (rows > 0)
     cols = strlen(grid[0]);
 
+  PHASE_MARK("solve");
   long long total_removed_count = 0;
 
   while (true) {
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h" // Memory report with -DAOC_ALLOCS
+
 #define MAX_RANGES 100000 // Sufficient space for many ranges
 
 typedef struct {
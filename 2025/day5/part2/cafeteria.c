@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_RANGES 10000 // Adjust if input is very large
 
 typedef struct {
@@ -27,6 +29,7 @@ int main() {
   int count = 0;
   char line[256];
 
+  PHASE_MARK("parse");
   // 1. Read and Parse Input
   while (fgets(line, sizeof(line), stdin)) {
     if (strchr(line, '-') != NULL) {
@@ -46,9 +49,11 @@ int main() {
     return 0;
   }
 
+  PHASE_MARK("build");
   // 2. Sort ranges by start value
   qsort(ranges, count, sizeof(Range), compare_ranges);
 
+  PHASE_MARK("solve");
   long long total_fresh = 0;
 
   // Initialize the "current merged range" with the first one
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_ROWS 1000
 #define MAX_COLS 4096 // Handles very wide inputs
 
@@ -24,6 +26,7 @@ bool is_col_empty(int col_index) {
 }
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Initialize grid with spaces
   for (int i = 0; i < MAX_ROWS; i++) {
     for (int j = 0; j < MAX_COLS; j++) {
@@ -42,6 +45,7 @@ int main() {
     num_rows++;
   }
 
+  PHASE_MARK("solve");
   long long grand_total = 0;
   int c = 0;
 
@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_ROWS 1000
 #define MAX_COLS 4096
 
@@ -23,6 +25,7 @@ bool is_col_empty(int c) {
 }
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Initialize grid with spaces
   // This ensures that areas past the end of short lines are treated as empty
   for (int r = 0; r < MAX_ROWS; r++) {
@@ -46,6 +49,7 @@ int main() {
     num_rows++;
   }
 
+  PHASE_MARK("solve");
   long long grand_total = 0;
   int c = 0;
 
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_COLS 1024
 #define MAX_ROWS 1024
 
@@ -13,6 +15,7 @@ int main() {
   int rows = 0;
   int cols = 0;
 
+  PHASE_MARK("parse");
   // Read input into grid
   while (scanf("%s", grid[rows]) == 1) {
     rows++;
@@ -20,6 +23,7 @@ int main() {
   if (rows > 0)
     cols = strlen(grid[0]);
 
+  PHASE_MARK("solve");
   // Initial state: Find the starting beam 'S'
   memset(active_beams, 0, sizeof(active_beams));
   for (int c = 0; c < cols; c++) {
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../../common/phase.h"
+
 #define MAX_COLS 2048
 #define MAX_ROWS 2048
 
@@ -13,6 +15,7 @@ int main() {
   int rows = 0;
   int cols = 0;
 
+  PHASE_MARK("parse");
   // 1. Read input
   while (scanf("%s", grid[rows]) == 1) {
     rows++;
@@ -20,6 +23,7 @@ int main() {
   if (rows > 0)
     cols = strlen(grid[0]);
 
+  PHASE_MARK("solve");
   // 2. Initialize: Find 'S' and start with 1 timeline there
   memset(current_counts, 0, sizeof(current_counts));
   for (int c = 0; c < cols; c++) {
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/phase.h"
+
 // Δομή για την αναπαράσταση ενός Junction Box (σημείο στο χώρο)
 typedef struct {
   int id;
@@ -60,6 +62,7 @@ int compare_sizes(const void *a, const void *b) {
 }
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Αρχικοποίηση και ανάγνωση δεδομένων
   int capacity = 1000;
   int n = 0;
@@ -79,6 +82,7 @@ int main() {
     n++;
   }
 
+  PHASE_MARK("build");
   // 2. Δημιουργία όλων των πιθανών ζευγών (ακμών)
   // Προσοχή: Για μεγάλο N, αυτό απαιτεί μνήμη. Για το puzzle αυτό είναι συνήθως
   // ασφαλές.
@@ -100,8 +104,9 @@ int main() {
   }
 
   // 3. Ταξινόμηση των ακμών βάσει απόστασης
-  qsort(edges, edge_count, sizeof(Edge), compare_edges);
+  PHASE("sort") qsort(edges, edge_count, sizeof(Edge), compare_edges);
 
+  PHASE_MARK("solve");
   // 4. Αρχικοποίηση δομής DSU
   parent = malloc(n * sizeof(int));
   sz = malloc(n * sizeof(int));
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/phase.h"
+
 // Δομή για την αναπαράσταση ενός Junction Box
 typedef struct {
   int id;
@@ -49,6 +51,7 @@ int compare_edges(const void *a, const void *b) {
 }
 
 int main() {
+  PHASE_MARK("parse");
   // 1. Ανάγνωση Δεδομένων
   int capacity = 1000;
   int n = 0;
@@ -67,6 +70,7 @@ int main() {
     n++;
   }
 
+  PHASE_MARK("build");
   // 2. Δημιουργία όλων των ακμών
   long long max_edges = (long long)n * (n - 1) / 2;
   Edge *edges = malloc(max_edges * sizeof(Edge));
@@ -86,8 +90,9 @@ int main() {
   }
 
   // 3. Ταξινόμηση ακμών (Shortest Path logic)
-  qsort(edges, edge_count, sizeof(Edge), compare_edges);
+  PHASE("sort") qsort(edges, edge_count, sizeof(Edge), compare_edges);
 
+  PHASE_MARK("solve");
   // 4. Αρχικοποίηση DSU
   parent = malloc(n * sizeof(int));
   for (int i = 0; i < n; i++) {
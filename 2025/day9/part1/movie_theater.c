@@ -1,18 +1,112 @@
-#include <math.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../../common/phase.h"
+
 // Δομή για την αποθήκευση συντεταγμένων
 typedef struct {
   int x;
   int y;
 } Point;
 
+// Συνάρτηση σύγκρισης για την qsort (αύξουσα κατά X, μετά κατά Y)
+int compare_points(const void *a, const void *b) {
+  const Point *p1 = (const Point *)a;
+  const Point *p2 = (const Point *)b;
+  if (p1->x != p2->x)
+    return (p1->x < p2->x) ? -1 : 1;
+  if (p1->y != p2->y)
+    return (p1->y < p2->y) ? -1 : 1;
+  return 0;
+}
+
+// Κατασκευή των δύο "σκαλών" (Pareto συνόρων) από ταξινομημένα σημεία.
+// lower: σημεία που δεν έχουν κανένα άλλο κάτω-αριστερά τους (X αύξουσα, Y
+// φθίνουσα). upper: σημεία που δεν έχουν κανένα άλλο πάνω-δεξιά τους (επίσης
+// X αύξουσα, Y φθίνουσα).
+// Μόνο αυτά τα σημεία μπορούν να είναι γωνίες του μέγιστου ορθογωνίου "/".
+// Σημείωση: οι κορυφές του κυρτού περιβλήματος ΔΕΝ αρκούν, αφού το εμβαδόν
+// (dx+1)*(dy+1) δεν είναι κυρτή συνάρτηση.
+void build_staircases(Point *sorted, int n, Point *lower, int *lower_count,
+                      Point *upper, int *upper_count) {
+  *lower_count = 0;
+  int min_y = INT_MAX;
+  for (int i = 0; i < n; i++) {
+    if (sorted[i].y < min_y) {
+      min_y = sorted[i].y;
+      lower[(*lower_count)++] = sorted[i];
+    }
+  }
+
+  // Σάρωση από δεξιά προς αριστερά, μετά αντιστροφή της σειράς
+  *upper_count = 0;
+  int max_y = INT_MIN;
+  for (int i = n - 1; i >= 0; i--) {
+    if (sorted[i].y > max_y) {
+      max_y = sorted[i].y;
+      upper[(*upper_count)++] = sorted[i];
+    }
+  }
+  for (int i = 0, j = *upper_count - 1; i < j; i++, j--) {
+    Point tmp = upper[i];
+    upper[i] = upper[j];
+    upper[j] = tmp;
+  }
+}
+
+// Divide & Conquer πάνω στον πίνακα area(i, j) = (dx+1)*(dy+1).
+// Ο πίνακας είναι supermodular, άρα η βέλτιστη στήλη opt(i) είναι μονότονη ως
+// προς i: κόστος O(h log h) αντί για O(h²).
+void solve_range(Point *lower, Point *upper, int l, int r, int opt_l,
+                 int opt_r, long long *max_area) {
+  if (l > r)
+    return;
+
+  int mid = (l + r) / 2;
+  long long best = LLONG_MIN;
+  int best_j = opt_l;
+
+  for (int j = opt_l; j <= opt_r; j++) {
+    long long dx = (long long)upper[j].x - lower[mid].x + 1;
+    long long dy = (long long)upper[j].y - lower[mid].y + 1;
+    long long area = dx * dy;
+    // Με ">=" κρατάμε το δεξιότερο argmax, ώστε η μονοτονία να ισχύει και σε
+    // ισοπαλίες
+    if (area >= best) {
+      best = area;
+      best_j = j;
+    }
+  }
+
+  if (best > *max_area) {
+    *max_area = best;
+  }
+
+  solve_range(lower, upper, l, mid - 1, opt_l, best_j, max_area);
+  solve_range(lower, upper, mid + 1, r, best_j, opt_r, max_area);
+}
+
+// Μέγιστο εμβαδόν για ζεύγη προσανατολισμού "/" (το ένα σημείο κάτω-αριστερά
+// του άλλου). Ο πίνακας tiles ταξινομείται επί τόπου.
+long long max_area_diagonal(Point *tiles, int count, Point *lower,
+                            Point *upper) {
+  qsort(tiles, count, sizeof(Point), compare_points);
+
+  int lower_count, upper_count;
+  build_staircases(tiles, count, lower, &lower_count, upper, &upper_count);
+
+  long long max_area = 0;
+  solve_range(lower, upper, 0, lower_count - 1, 0, upper_count - 1, &max_area);
+  return max_area;
+}
+
 int main() {
   int capacity = 1000;
   int count = 0;
   Point *tiles = malloc(capacity * sizeof(Point));
 
+  PHASE_MARK("parse");
   // 1. Ανάγνωση εισόδου (μορφή X,Y)
   // Διαβάζουμε μέχρι να τελειώσει το αρχείο
   while (scanf("%d,%d", &tiles[count].x, &tiles[count].y) == 2) {
@@ -24,28 +118,35 @@ int main() {
     }
   }
 
+  PHASE_MARK("solve");
   long long max_area = 0;
 
-  // 2. Έλεγχος όλων των πιθανών ζευγών (Brute Force)
-  for (int i = 0; i < count; i++) {
-    for (int j = i + 1; j < count; j++) {
-
-      // Υπολογισμός διαφοράς συντεταγμένων
-      long long dx = abs(tiles[i].x - tiles[j].x);
-      long long dy = abs(tiles[i].y - tiles[j].y);
+  if (count >= 2) {
+    Point *lower = malloc(count * sizeof(Point));
+    Point *upper = malloc(count * sizeof(Point));
 
-      // Υπολογισμός εμβαδού (Inclusive: +1 σε κάθε διάσταση)
-      // Στο παράδειγμα: |9-2|=7 -> πλάτος 8, |7-5|=2 -> ύψος 3. 8*3=24.
-      long long area = (dx + 1) * (dy + 1);
+    // 2. Προσανατολισμός "/": γωνίες κάτω-αριστερά και πάνω-δεξιά
+    // Στο παράδειγμα: |9-2|=7 -> πλάτος 8, |7-5|=2 -> ύψος 3. 8*3=24.
+    long long area = max_area_diagonal(tiles, count, lower, upper);
+    if (area > max_area) {
+      max_area = area;
+    }
 
-      if (area > max_area) {
-        max_area = area;
-      }
+    // 3. Προσανατολισμός "\": καθρεπτισμός του άξονα X και ίδιος υπολογισμός
+    for (int i = 0; i < count; i++) {
+      tiles[i].x = -tiles[i].x;
+    }
+    area = max_area_diagonal(tiles, count, lower, upper);
+    if (area > max_area) {
+      max_area = area;
     }
+
+    free(lower);
+    free(upper);
   }
 
   printf("Largest area: %lld\n", max_area);
 
   free(tiles);
   return 0;
-}
\ No newline at end of file
+}
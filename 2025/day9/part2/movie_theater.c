@@ -1,7 +1,22 @@
-#include <math.h>
+// Μεταγλώττιση: gcc -O2 -pthread movie_theater.c
+
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+
+#include "../../common/phase.h"
+
+// Όριο κελιών για το συμπιεσμένο πλέγμα. Πάνω από αυτό επιστρέφουμε στους
+// γεωμετρικούς ελέγχους (ray casting + τομές ακμών).
+#ifndef MAX_GRID_CELLS
+#define MAX_GRID_CELLS (1LL << 26)
+#endif
+
+// Μέγιστο πλήθος νημάτων
+#define MAX_THREADS 64
 
 // Δομή για την αποθήκευση σημείων (X, Y)
 typedef struct {
@@ -15,86 +30,535 @@ typedef struct {
   long long min_y, max_y;
 } Rect;
 
+// Συμπιεσμένο πλέγμα με 2D prefix sums των "εξωτερικών" κελιών.
+// Κάθε διακριτή τιμή X γίνεται μια στήλη, και κάθε κενό ανάμεσα σε δύο
+// διαδοχικές τιμές γίνεται άλλη μία στήλη (ομοίως για το Y). Γύρω-γύρω
+// υπάρχει ένα κελί περιθώριο που είναι πάντα έξω από το πολύγωνο.
+typedef struct {
+  int width, height;   // Διαστάσεις του πλέγματος (με το περιθώριο)
+  int *outside_prefix; // (width+1) x (height+1) prefix sums
+  int *cx, *cy;        // Συμπιεσμένος δείκτης για κάθε πλακίδιο
+} Grid;
+
 // Βοηθητική συνάρτηση: min/max
 long long min_val(long long a, long long b) { return (a < b) ? a : b; }
 long long max_val(long long a, long long b) { return (a > b) ? a : b; }
 
-// Έλεγχος αν το κέντρο του ορθογωνίου είναι μέσα στο πολύγωνο (Ray Casting)
-// Το πολύγωνο ορίζεται από τον πίνακα tiles (μέγεθος n)
-bool is_center_inside(Rect r, Point *tiles, int n) {
-  // Το κέντρο του ορθογωνίου (σε double για ακρίβεια)
-  double cx = (r.min_x + r.max_x) / 2.0;
-  double cy = (r.min_y + r.max_y) / 2.0;
+// Συνάρτηση σύγκρισης για την qsort (αύξουσα σειρά)
+int compare_ll(const void *a, const void *b) {
+  long long x = *(const long long *)a;
+  long long y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+// Ταξινόμηση και αφαίρεση διπλοτύπων. Επιστρέφει το πλήθος μοναδικών τιμών.
+int unique_sorted(long long *values, int n) {
+  qsort(values, n, sizeof(long long), compare_ll);
+  int k = 0;
+  for (int i = 0; i < n; i++) {
+    if (k == 0 || values[k - 1] != values[i])
+      values[k++] = values[i];
+  }
+  return k;
+}
 
-  int intersections = 0;
+// Δυαδική αναζήτηση: δείκτης της τιμής v στον ταξινομημένο πίνακα
+int index_of(long long *values, int n, long long v) {
+  int lo = 0, hi = n - 1;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (values[mid] < v)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
 
+// Κατασκευή του πλέγματος: συμπίεση, σχεδίαση των ακμών, flood fill από το
+// περιθώριο για τα εξωτερικά κελιά, και τέλος prefix sums.
+// Επιστρέφει false αν το πλέγμα ξεπερνά το MAX_GRID_CELLS.
+bool build_grid(Grid *g, Point *tiles, int n) {
+  long long *xs = malloc(n * sizeof(long long));
+  long long *ys = malloc(n * sizeof(long long));
   for (int i = 0; i < n; i++) {
-    Point p1 = tiles[i];
-    Point p2 = tiles[(i + 1) % n]; // Κυκλική σύνδεση (το τελευταίο με το πρώτο)
+    xs[i] = tiles[i].x;
+    ys[i] = tiles[i].y;
+  }
+  int nx = unique_sorted(xs, n);
+  int ny = unique_sorted(ys, n);
+
+  // Η τιμή k αντιστοιχεί στο κελί 2k+1, το κενό μετά από αυτή στο 2k+2
+  g->width = 2 * nx + 1;
+  g->height = 2 * ny + 1;
+  if ((long long)g->width * g->height > MAX_GRID_CELLS) {
+    free(xs);
+    free(ys);
+    return false;
+  }
 
-    // Έλεγχος αν η ακμή τέμνει την οριζόντια ακτίνα που ξεκινάει από το (cx,
-    // cy) Ray Casting: Κοιτάμε αν το cy είναι ανάμεσα στα Y των άκρων της ακμής
-    if ((p1.y > cy) != (p2.y > cy)) {
-      // Υπολογισμός του X στο σημείο τομής
-      double intersectX =
-          (p2.x - p1.x) * (cy - p1.y) / (double)(p2.y - p1.y) + p1.x;
+  g->cx = malloc(n * sizeof(int));
+  g->cy = malloc(n * sizeof(int));
+  for (int i = 0; i < n; i++) {
+    g->cx[i] = 2 * index_of(xs, nx, tiles[i].x) + 1;
+    g->cy[i] = 2 * index_of(ys, ny, tiles[i].y) + 1;
+  }
+  free(xs);
+  free(ys);
 
-      // Μετράμε μόνο αν η τομή είναι δεξιά από το σημείο μας
-      if (cx < intersectX) {
-        intersections++;
+  int w = g->width, h = g->height;
+  // 0 = άγνωστο, 1 = όριο (κόκκινο/πράσινο), 2 = έξω
+  unsigned char *cell = calloc((size_t)w * h, 1);
+
+  // 1. Σχεδίαση των ακμών του πολυγώνου
+  for (int i = 0; i < n; i++) {
+    int j = (i + 1) % n;
+    int x0 = g->cx[i] < g->cx[j] ? g->cx[i] : g->cx[j];
+    int x1 = g->cx[i] < g->cx[j] ? g->cx[j] : g->cx[i];
+    int y0 = g->cy[i] < g->cy[j] ? g->cy[i] : g->cy[j];
+    int y1 = g->cy[i] < g->cy[j] ? g->cy[j] : g->cy[i];
+    for (int x = x0; x <= x1; x++)
+      for (int y = y0; y <= y1; y++)
+        cell[(size_t)y * w + x] = 1;
+  }
+
+  // 2. Flood fill (επαναληπτικό, με στοίβα) από τη γωνία του περιθωρίου
+  int *stack = malloc((size_t)w * h * sizeof(int));
+  int top = 0;
+  stack[top++] = 0;
+  cell[0] = 2;
+  while (top > 0) {
+    int id = stack[--top];
+    int x = id % w, y = id / w;
+    int nbr[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+    for (int k = 0; k < 4; k++) {
+      int nx2 = nbr[k][0], ny2 = nbr[k][1];
+      if (nx2 < 0 || nx2 >= w || ny2 < 0 || ny2 >= h)
+        continue;
+      int nid = ny2 * w + nx2;
+      if (cell[nid] == 0) {
+        cell[nid] = 2;
+        stack[top++] = nid;
       }
     }
   }
+  free(stack);
 
-  // Αν οι τομές είναι περιττός αριθμός, είμαστε μέσα.
-  return (intersections % 2 != 0);
+  // 3. 2D prefix sums των εξωτερικών κελιών
+  g->outside_prefix = calloc((size_t)(w + 1) * (h + 1), sizeof(int));
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      size_t at = (size_t)(y + 1) * (w + 1) + (x + 1);
+      g->outside_prefix[at] = (cell[(size_t)y * w + x] == 2) +
+                              g->outside_prefix[at - 1] +
+                              g->outside_prefix[at - (w + 1)] -
+                              g->outside_prefix[at - (w + 1) - 1];
+    }
+  }
+  free(cell);
+  return true;
+}
+
+void free_grid(Grid *g) {
+  free(g->outside_prefix);
+  free(g->cx);
+  free(g->cy);
 }
 
-// Έλεγχος αν κάποια πλευρά του πολυγώνου "κόβει" το ορθογώνιο στη μέση
-bool do_edges_intersect(Rect r, Point *tiles, int n) {
+// O(1) έλεγχος: το ορθογώνιο με γωνίες τα πλακίδια i, j δεν περιέχει κανένα
+// εξωτερικό κελί
+bool is_rect_inside(Grid *g, int i, int j) {
+  int x0 = g->cx[i] < g->cx[j] ? g->cx[i] : g->cx[j];
+  int x1 = g->cx[i] < g->cx[j] ? g->cx[j] : g->cx[i];
+  int y0 = g->cy[i] < g->cy[j] ? g->cy[i] : g->cy[j];
+  int y1 = g->cy[i] < g->cy[j] ? g->cy[j] : g->cy[i];
+  int stride = g->width + 1;
+  int *p = g->outside_prefix;
+  int outside = p[(y1 + 1) * stride + (x1 + 1)] - p[y0 * stride + (x1 + 1)] -
+                p[(y1 + 1) * stride + x0] + p[y0 * stride + x0];
+  return outside == 0;
+}
+
+// Ακμή του πολυγώνου ως διάστημα [lo, hi] πάνω στη σταθερή συντεταγμένη της
+// (X για κάθετες ακμές, Y για οριζόντιες)
+typedef struct {
+  long long fixed;
+  long long lo, hi;
+} Segment;
+
+// Δέντρο Fenwick πάνω στις κάθετες ακμές, ταξινομημένες κατά ένα άκρο τους
+// (κάτω ή πάνω, σε διπλάσιες συντεταγμένες). Ο κόμβος k καλύπτει τις ακμές
+// (k - lowbit(k), k] και κρατάει ταξινομημένα τα διπλάσια X τους, οπότε το
+// πλήθος ακμών με άκρο <= E και X > C βγαίνει σε O(log^2 n).
+typedef struct {
+  int count;
+  long long *ends; // Τα άκρα, σε αύξουσα σειρά
+  long long *xs;   // Τα X κάθε κόμβου, ταξινομημένα
+  int *start;      // Ο κόμβος k πιάνει τα xs[start[k] .. start[k + 1])
+} EndTree;
+
+// Ευρετήριο ακμών: κάθετες και οριζόντιες σε ξεχωριστούς πίνακες,
+// ταξινομημένους κατά τη σταθερή συντεταγμένη για δυαδική αναζήτηση, και
+// δύο δέντρα για το ray casting
+typedef struct {
+  Segment *vertical;
+  int num_vertical;
+  Segment *horizontal;
+  int num_horizontal;
+  EndTree lower, upper; // Κατά κάτω και κατά πάνω άκρο
+} EdgeIndex;
+
+// Συνάρτηση σύγκρισης για την qsort (αύξουσα κατά σταθερή συντεταγμένη)
+int compare_segments(const void *a, const void *b) {
+  const Segment *s1 = (const Segment *)a;
+  const Segment *s2 = (const Segment *)b;
+  return (s1->fixed > s2->fixed) - (s1->fixed < s2->fixed);
+}
+
+// Ζεύγος (άκρο, X) για το χτίσιμο ενός EndTree
+typedef struct {
+  long long end, x;
+} EndX;
+
+int compare_end_x(const void *a, const void *b) {
+  const EndX *p1 = (const EndX *)a;
+  const EndX *p2 = (const EndX *)b;
+  return (p1->end > p2->end) - (p1->end < p2->end);
+}
+
+void build_end_tree(EndTree *t, EndX *pairs, int count) {
+  qsort(pairs, count, sizeof(EndX), compare_end_x);
+  t->count = count;
+  t->ends = malloc((count + 1) * sizeof(long long));
+  t->start = malloc((count + 2) * sizeof(int));
+  t->start[1] = 0;
+  for (int k = 1; k <= count; k++) {
+    t->ends[k - 1] = pairs[k - 1].end;
+    t->start[k + 1] = t->start[k] + (k & -k);
+  }
+  t->xs = malloc((t->start[count + 1] + 1) * sizeof(long long));
+  for (int k = 1; k <= count; k++) {
+    long long *xs = t->xs + t->start[k];
+    int len = k & -k;
+    for (int i = 0; i < len; i++)
+      xs[i] = pairs[k - len + i].x;
+    qsort(xs, len, sizeof(long long), compare_ll);
+  }
+}
+
+void free_end_tree(EndTree *t) {
+  free(t->ends);
+  free(t->xs);
+  free(t->start);
+}
+
+// Πλήθος ακμών με άκρο <= end_limit και X > x_limit
+int count_end_tree(EndTree *t, long long end_limit, long long x_limit) {
+  int lo = 0, hi = t->count; // Πόσα άκρα είναι <= end_limit
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (t->ends[mid] <= end_limit)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  int total = 0;
+  for (int k = lo; k > 0; k -= k & -k) {
+    long long *xs = t->xs + t->start[k];
+    int len = t->start[k + 1] - t->start[k];
+    int a = 0, b = len;
+    while (a < b) { // Πρώτο X > x_limit
+      int mid = (a + b) / 2;
+      if (xs[mid] <= x_limit)
+        a = mid + 1;
+      else
+        b = mid;
+    }
+    total += len - a;
+  }
+  return total;
+}
+
+void build_edge_index(EdgeIndex *idx, Point *tiles, int n) {
+  idx->vertical = malloc(n * sizeof(Segment));
+  idx->horizontal = malloc(n * sizeof(Segment));
+  idx->num_vertical = 0;
+  idx->num_horizontal = 0;
+
   for (int i = 0; i < n; i++) {
     Point p1 = tiles[i];
-    Point p2 = tiles[(i + 1) % n];
+    Point p2 = tiles[(i + 1) % n]; // Κυκλική σύνδεση (το τελευταίο με το πρώτο)
 
-    // Έλεγχος αν η ακμή είναι κάθετη
     if (p1.x == p2.x) {
-      long long edge_x = p1.x;
-      long long y_start = min_val(p1.y, p2.y);
-      long long y_end = max_val(p1.y, p2.y);
-
-      // Για να "κόψει" το ορθογώνιο, το X της ακμής πρέπει να είναι ΑΥΣΤΗΡΑ
-      // ανάμεσα στα X του ορθογωνίου Και τα Y να αλληλεπικαλύπτονται
-      if (edge_x > r.min_x && edge_x < r.max_x) {
-        // Έλεγχος επικάλυψης στον άξονα Y
-        // Αν το διάστημα [y_start, y_end] έχει κοινά σημεία με το [r.min_y,
-        // r.max_y]
-        if (max_val(y_start, r.min_y) < min_val(y_end, r.max_y)) {
-          return true; // Υπάρχει τομή
-        }
-      }
+      Segment s = {p1.x, min_val(p1.y, p2.y), max_val(p1.y, p2.y)};
+      idx->vertical[idx->num_vertical++] = s;
+    } else if (p1.y == p2.y) {
+      Segment s = {p1.y, min_val(p1.x, p2.x), max_val(p1.x, p2.x)};
+      idx->horizontal[idx->num_horizontal++] = s;
     }
-    // Έλεγχος αν η ακμή είναι οριζόντια
-    else if (p1.y == p2.y) {
-      long long edge_y = p1.y;
-      long long x_start = min_val(p1.x, p2.x);
-      long long x_end = max_val(p1.x, p2.x);
-
-      // Αντίστοιχος έλεγχος για οριζόντια τομή
-      if (edge_y > r.min_y && edge_y < r.max_y) {
-        if (max_val(x_start, r.min_x) < min_val(x_end, r.max_x)) {
-          return true; // Υπάρχει τομή
-        }
-      }
+  }
+
+  qsort(idx->vertical, idx->num_vertical, sizeof(Segment), compare_segments);
+  qsort(idx->horizontal, idx->num_horizontal, sizeof(Segment),
+        compare_segments);
+
+  EndX *pairs = malloc((idx->num_vertical + 1) * sizeof(EndX));
+  for (int i = 0; i < idx->num_vertical; i++) {
+    Segment s = idx->vertical[i];
+    pairs[i] = (EndX){2 * s.lo, 2 * s.fixed};
+  }
+  build_end_tree(&idx->lower, pairs, idx->num_vertical);
+  for (int i = 0; i < idx->num_vertical; i++) {
+    Segment s = idx->vertical[i];
+    pairs[i] = (EndX){2 * s.hi, 2 * s.fixed};
+  }
+  build_end_tree(&idx->upper, pairs, idx->num_vertical);
+  free(pairs);
+}
+
+void free_edge_index(EdgeIndex *idx) {
+  free(idx->vertical);
+  free(idx->horizontal);
+  free_end_tree(&idx->lower);
+  free_end_tree(&idx->upper);
+}
+
+// Δυαδική αναζήτηση: πρώτη ακμή με σταθερή συντεταγμένη ΑΥΣΤΗΡΑ > value
+int first_above(Segment *segs, int count, long long value) {
+  int lo = 0, hi = count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (segs[mid].fixed <= value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// Έλεγχος αν το κέντρο του ορθογωνίου είναι μέσα στο πολύγωνο (Ray Casting)
+// Δουλεύουμε με διπλάσιες συντεταγμένες ώστε το κέντρο να είναι ακέραιο. Το
+// πολύγωνο είναι ορθογώνιο, άρα μόνο οι κάθετες ακμές τέμνουν την ακτίνα, και
+// από αυτές μόνο όσες βρίσκονται δεξιά από το κέντρο. Η ακτίνα τέμνει όσες
+// έχουν lo <= cy < hi: όσες έχουν lo <= cy μείον όσες έχουν hi <= cy (αφού
+// lo < hi), δηλαδή δύο ερωτήματα O(log^2 n) αντί για σάρωση O(n).
+bool is_center_inside(Rect r, EdgeIndex *idx) {
+  long long cx2 = r.min_x + r.max_x;
+  long long cy2 = r.min_y + r.max_y;
+
+  int intersections = count_end_tree(&idx->lower, cy2, cx2) -
+                      count_end_tree(&idx->upper, cy2, cx2);
+
+  // Αν οι τομές είναι περιττός αριθμός, είμαστε μέσα.
+  return (intersections % 2 != 0);
+}
+
+// Έλεγχος αν κάποια πλευρά του πολυγώνου "κόβει" το ορθογώνιο στη μέση.
+// Για να "κόψει" το ορθογώνιο, η σταθερή συντεταγμένη της ακμής πρέπει να
+// είναι ΑΥΣΤΗΡΑ ανάμεσα στα όρια του ορθογωνίου. Με δυαδική αναζήτηση
+// εξετάζουμε μόνο αυτές τις ακμές: O(log n + k) αντί για O(n).
+bool do_edges_intersect(Rect r, EdgeIndex *idx) {
+  // Κάθετες ακμές με min_x < X < max_x: έλεγχος επικάλυψης στον άξονα Y
+  for (int i = first_above(idx->vertical, idx->num_vertical, r.min_x);
+       i < idx->num_vertical && idx->vertical[i].fixed < r.max_x; i++) {
+    Segment s = idx->vertical[i];
+    if (max_val(s.lo, r.min_y) < min_val(s.hi, r.max_y)) {
+      return true; // Υπάρχει τομή
+    }
+  }
+
+  // Οριζόντιες ακμές με min_y < Y < max_y: έλεγχος επικάλυψης στον άξονα X
+  for (int i = first_above(idx->horizontal, idx->num_horizontal, r.min_y);
+       i < idx->num_horizontal && idx->horizontal[i].fixed < r.max_y; i++) {
+    Segment s = idx->horizontal[i];
+    if (max_val(s.lo, r.min_x) < min_val(s.hi, r.max_x)) {
+      return true; // Υπάρχει τομή
     }
   }
   return false;
 }
 
+// Οκτημόριο της κατεύθυνσης (dx, dy): 0 = +X, 1 = +X+Y, 2 = +Y, ... , 7
+int octant(long long dx, long long dy) {
+  static const int table[3][3] = {{5, 4, 3}, {6, -1, 2}, {7, 0, 1}};
+  return table[(dx > 0) - (dx < 0) + 1][(dy > 0) - (dy < 0) + 1];
+}
+
+// Για κάθε πλακίδιο-κορυφή, ποια από τα τέσσερα τεταρτημόρια γύρω του
+// (bit = διαγώνιο οκτημόριο 1, 3, 5, 7) είναι μέσα στο πολύγωνο. Το
+// εσωτερικό είναι ο τομέας από την επόμενη ακμή ως την προηγούμενη, με τη
+// φορά του πολυγώνου. Ένα μη εκφυλισμένο ορθογώνιο με γωνία ένα πλακίδιο
+// απλώνεται σε ένα τεταρτημόριό του, που πρέπει να είναι μέσα.
+unsigned char *inner_quadrants(Point *tiles, int n) {
+  unsigned char *inner = malloc(n > 0 ? n : 1);
+  __int128 area2 = 0; // Διπλάσιο προσημασμένο εμβαδόν (shoelace)
+  for (int i = 0; i < n; i++) {
+    Point p = tiles[i], q = tiles[(i + 1) % n];
+    area2 += (__int128)p.x * q.y - (__int128)q.x * p.y;
+  }
+  for (int i = 0; i < n; i++) {
+    Point p = tiles[i];
+    Point prev = tiles[(i + n - 1) % n], next = tiles[(i + 1) % n];
+    int a = octant(prev.x - p.x, prev.y - p.y);
+    int b = octant(next.x - p.x, next.y - p.y);
+    if (area2 == 0 || a < 0 || b < 0 || a == b) {
+      inner[i] = 0xFF; // Εκφυλισμένη κορυφή: κανένας περιορισμός
+      continue;
+    }
+    if (area2 < 0) { // Δεξιόστροφο: το εσωτερικό από την a ως την b
+      int t = a;
+      a = b;
+      b = t;
+    }
+    inner[i] = 0;
+    for (int d = 1; d < 8; d += 2)
+      if ((d - b + 8) % 8 < (a - b + 8) % 8)
+        inner[i] |= 1 << d;
+  }
+  return inner;
+}
+
+// Αναγκαία συνθήκη O(1): το ορθογώνιο i, j ανοίγει προς εσωτερικό
+// τεταρτημόριο και στις δύο γωνίες του (αν δεν είναι εκφυλισμένο)
+bool corners_open(Point *tiles, unsigned char *inner, int i, int j) {
+  long long dx = tiles[j].x - tiles[i].x, dy = tiles[j].y - tiles[i].y;
+  if (dx == 0 || dy == 0)
+    return true;
+  return (inner[i] >> octant(dx, dy) & 1) &&
+         (inner[j] >> octant(-dx, -dy) & 1);
+}
+
+// Υποψήφιο ορθογώνιο: τα δύο πλακίδια-γωνίες και το εμβαδόν του
+typedef struct {
+  long long area;
+  int i, j;
+} Candidate;
+
+// Κοινή κατάσταση της παράλληλης αναζήτησης. Οι υποψήφιοι δεν φτιάχνονται
+// όλοι μαζί (n(n-1)/2 θα ήθελαν O(n^2) μνήμη): κάθε πλακίδιο i είναι μια
+// "άγκυρα" με το μεγαλύτερο εμβαδόν που δίνει με κάποιο j > i, και οι
+// υποψήφιοι μιας άγκυρας φτιάχνονται μόνο όταν την πάρει ένα νήμα.
+typedef struct {
+  Point *tiles;
+  int n;
+  Candidate *anchors; // Ταξινομημένες κατά φθίνον μέγιστο εμβαδόν
+  int num_anchors;
+  unsigned char *inner; // Εσωτερικά τεταρτημόρια κάθε πλακιδίου
+  bool use_grid;
+  Grid *grid;
+  EdgeIndex *edges;
+  atomic_llong next;     // Επόμενη άγκυρα προς επεξεργασία
+  atomic_llong max_area; // Κοινό καλύτερο εμβαδόν (όριο για pruning)
+} SearchContext;
+
+// Συνάρτηση σύγκρισης για την qsort (φθίνουσα σειρά εμβαδού)
+int compare_candidates(const void *a, const void *b) {
+  const Candidate *c1 = (const Candidate *)a;
+  const Candidate *c2 = (const Candidate *)b;
+  return (c1->area < c2->area) - (c1->area > c2->area);
+}
+
+// Υπολογισμός Εμβαδού (Inclusive: +1 σε κάθε διάσταση)
+long long rect_area(Point *tiles, int i, int j) {
+  long long dx =
+      max_val(tiles[i].x, tiles[j].x) - min_val(tiles[i].x, tiles[j].x) + 1;
+  long long dy =
+      max_val(tiles[i].y, tiles[j].y) - min_val(tiles[i].y, tiles[j].y) + 1;
+  return dx * dy;
+}
+
+// Έλεγχοι εγκυρότητας για το ορθογώνιο με γωνίες τα πλακίδια i, j
+bool is_valid(SearchContext *ctx, int i, int j) {
+  if (ctx->use_grid) {
+    // Ένα lookup στα prefix sums
+    return is_rect_inside(ctx->grid, i, j);
+  }
+
+  Point *tiles = ctx->tiles;
+  Rect r;
+  r.min_x = min_val(tiles[i].x, tiles[j].x);
+  r.max_x = max_val(tiles[i].x, tiles[j].x);
+  r.min_y = min_val(tiles[i].y, tiles[j].y);
+  r.max_y = max_val(tiles[i].y, tiles[j].y);
+
+  // Α. Μήπως κάποιος τοίχος κόβει το ορθογώνιο; (συνήθως σταματά νωρίς)
+  // Β. Είναι το κέντρο μέσα στο πολύγωνο;
+  return !do_edges_intersect(r, ctx->edges) &&
+         is_center_inside(r, ctx->edges);
+}
+
+// Ενημέρωση του κοινού ορίου (compare-and-swap μέχρι να πετύχει ή να βρεθεί
+// ήδη μεγαλύτερο)
+void publish_area(SearchContext *ctx, long long area) {
+  long long best = atomic_load(&ctx->max_area);
+  while (area > best &&
+         !atomic_compare_exchange_weak(&ctx->max_area, &best, area))
+    ;
+}
+
+// Ελέγχει τα ορθογώνια της άγκυρας i που ξεπερνούν το κοινό όριο, από το
+// μεγαλύτερο προς το μικρότερο: το πρώτο έγκυρο είναι το καλύτερο της
+// άγκυρας. Το buffer (n θέσεις) είναι του νήματος· αν η malloc του απέτυχε
+// (NULL), ελέγχονται όλα χωρίς ταξινόμηση.
+void search_anchor(SearchContext *ctx, int i, Candidate *buffer) {
+  long long best = atomic_load(&ctx->max_area);
+  if (buffer == NULL) {
+    for (int j = i + 1; j < ctx->n; j++) {
+      long long area = rect_area(ctx->tiles, i, j);
+      if (area > best && corners_open(ctx->tiles, ctx->inner, i, j) &&
+          is_valid(ctx, i, j)) {
+        publish_area(ctx, area);
+        best = atomic_load(&ctx->max_area);
+      }
+    }
+    return;
+  }
+
+  int m = 0;
+  for (int j = i + 1; j < ctx->n; j++) {
+    long long area = rect_area(ctx->tiles, i, j);
+    if (area > best && corners_open(ctx->tiles, ctx->inner, i, j))
+      buffer[m++] = (Candidate){area, i, j};
+  }
+  qsort(buffer, m, sizeof(Candidate), compare_candidates);
+
+  for (int k = 0; k < m; k++) {
+    if (buffer[k].area <= atomic_load(&ctx->max_area))
+      return; // Τα υπόλοιπα είναι ακόμα μικρότερα
+    if (is_valid(ctx, i, buffer[k].j)) {
+      publish_area(ctx, buffer[k].area);
+      return;
+    }
+  }
+}
+
+// Νήμα εργασίας: παίρνει άγκυρες με τη σειρά (μεγαλύτερο μέγιστο εμβαδόν
+// πρώτα). Μόλις το μέγιστο της επόμενης δεν ξεπερνά το κοινό όριο, όλες οι
+// υπόλοιπες έχουν ακόμα μικρότερα, οπότε το νήμα σταματά.
+void *search_worker(void *arg) {
+  SearchContext *ctx = (SearchContext *)arg;
+  Candidate *buffer = malloc(ctx->n * sizeof(Candidate));
+
+  while (true) {
+    long long k = atomic_fetch_add(&ctx->next, 1);
+    if (k >= ctx->num_anchors)
+      break;
+    if (ctx->anchors[k].area <= atomic_load(&ctx->max_area))
+      break;
+    search_anchor(ctx, ctx->anchors[k].i, buffer);
+  }
+
+  free(buffer);
+  return NULL;
+}
+
 int main() {
   int capacity = 1000;
   int n = 0;
   Point *tiles = malloc(capacity * sizeof(Point));
 
+  PHASE_MARK("parse");
   // 1. Ανάγνωση εισόδου
   while (scanf("%lld,%lld", &tiles[n].x, &tiles[n].y) == 2) {
     n++;
@@ -104,42 +568,76 @@ int main() {
     }
   }
 
-  long long max_area = 0;
-
-  // 2. Εξέταση κάθε ζεύγους σημείων
-  for (int i = 0; i < n; i++) {
-    for (int j = i + 1; j < n; j++) {
+  PHASE_MARK("build");
+  // 2. Προεπεξεργασία: συμπιεσμένο πλέγμα (αν χωράει στη μνήμη)
+  Grid grid;
+  bool use_grid = n > 0 && build_grid(&grid, tiles, n);
 
-      // Δημιουργία του υποψήφιου ορθογωνίου
-      Rect r;
-      r.min_x = min_val(tiles[i].x, tiles[j].x);
-      r.max_x = max_val(tiles[i].x, tiles[j].x);
-      r.min_y = min_val(tiles[i].y, tiles[j].y);
-      r.max_y = max_val(tiles[i].y, tiles[j].y);
+  // Αλλιώς, ευρετήριο ακμών για τους γεωμετρικούς ελέγχους
+  EdgeIndex edges;
+  if (!use_grid)
+    build_edge_index(&edges, tiles, n);
 
-      // 3. Υπολογισμός Εμβαδού (Πρώτα, για να αποφύγουμε βαρύ έλεγχο αν είναι
-      // μικρότερο)
-      long long area = (r.max_x - r.min_x + 1) * (r.max_y - r.min_y + 1);
+  unsigned char *inner = inner_quadrants(tiles, n);
 
-      if (area <= max_area)
-        continue;
+  // 3. Μία άγκυρα ανά πλακίδιο (O(n) μνήμη), ταξινομημένες κατά φθίνον
+  // μέγιστο εμβαδόν (μόνο ορθογώνια που ανοίγουν προς το εσωτερικό)
+  int num_anchors = n > 1 ? n - 1 : 0;
+  Candidate *anchors = malloc((num_anchors + 1) * sizeof(Candidate));
+  if (anchors == NULL) {
+    fprintf(stderr, "Error: out of memory for %d tiles\n", n);
+    return 1;
+  }
+  for (int i = 0; i < num_anchors; i++) {
+    anchors[i] = (Candidate){0, i, i + 1};
+    for (int j = i + 1; j < n; j++) {
+      long long area = rect_area(tiles, i, j);
+      if (area > anchors[i].area && corners_open(tiles, inner, i, j))
+        anchors[i] = (Candidate){area, i, j};
+    }
+  }
+  PHASE("sort") {
+    qsort(anchors, num_anchors, sizeof(Candidate), compare_candidates);
+  }
 
-      // 4. Έλεγχοι Εγκυρότητας
-      // Α. Είναι το κέντρο μέσα στο πολύγωνο;
-      if (!is_center_inside(r, tiles, n))
-        continue;
+  PHASE_MARK("solve");
+  // 4. Παράλληλη αναζήτηση με κοινό όριο max_area
+  SearchContext ctx;
+  ctx.tiles = tiles;
+  ctx.inner = inner;
+  ctx.n = n;
+  ctx.anchors = anchors;
+  ctx.num_anchors = num_anchors;
+  ctx.use_grid = use_grid;
+  ctx.grid = &grid;
+  ctx.edges = &edges;
+  atomic_init(&ctx.next, 0);
+  atomic_init(&ctx.max_area, 0);
 
-      // Β. Μήπως κάποιος τοίχος κόβει το ορθογώνιο;
-      if (do_edges_intersect(r, tiles, n))
-        continue;
+  long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads > MAX_THREADS)
+    num_threads = MAX_THREADS;
 
-      // Αν περάσει τους ελέγχους, είναι έγκυρο
-      max_area = area;
-    }
+  pthread_t threads[MAX_THREADS];
+  for (long t = 0; t < num_threads; t++) {
+    pthread_create(&threads[t], NULL, search_worker, &ctx);
+  }
+  for (long t = 0; t < num_threads; t++) {
+    pthread_join(threads[t], NULL);
   }
 
+  long long max_area = atomic_load(&ctx.max_area);
+
   printf("Largest valid area (Part 2): %lld\n", max_area);
 
+  if (use_grid)
+    free_grid(&grid);
+  else
+    free_edge_index(&edges);
+  free(anchors);
+  free(inner);
   free(tiles);
   return 0;
-}
\ No newline at end of file
+}
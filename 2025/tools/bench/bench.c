@@ -0,0 +1,372 @@
+/**
+ * Benchmark runner for the 2025 solvers.
+ * * For every dayN/partM solver and every scale of the sweep, an input of
+ * scale times the real input's size is generated once (tools/gen, fixed
+ * seed), then the solver is run --reps times on it. Each run reports its
+ * phase totals (see common/phase.h) through $AOC_PHASE_FILE; the runner adds
+ * the wall time of the whole process as phase "total".
+ * * Output, one row per solver, scale and phase, with the median and the
+ * 99th percentile (nearest rank) over the runs, in milliseconds:
+ * csv:  day,part,scale,size,bytes,phase,runs,median_ms,p99_ms,peak_rss_kb
+ * json: an array of objects with the same fields.
+ * peak_rss_kb is the highest peak RSS of the solver over the runs (from
+ * wait4), the same on every row of a solver and scale.
+ * Solvers that parse and solve in one pass (days 2, 3, 5 part 1) only have
+ * "total". Runs that fail are reported on stderr and left out.
+ * * Build everything with build.sh, then:
+ * bench [--reps N] [--scales 0.5,1,2] [--format csv|json] [--only day8]
+ *       [--bin DIR] [--seed S]
+ * --only takes "dayN" or "dayN/partM"; --bin is the directory build.sh
+ * wrote to (default: the directory of this program).
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SCALES 16
+#define MAX_SERIES 32 // Phases per solver, "total" included
+#define PATH_LEN 4096
+
+/**
+ * One solver and how to size its input: the generator options in opt[] are
+ * all scaled together from the real input's sizes in base[]. Inputs whose
+ * first size exceeds limit (a fixed buffer in the solver) are skipped.
+ */
+typedef struct {
+  int day;
+  int part;
+  const char *opt[2];
+  long long base[2];
+  long long limit; // 0: none
+} Target;
+
+static const Target TARGETS[] = {
+    {1, 1, {"--n"}, {4732}, 0},
+    {1, 2, {"--n"}, {4732}, 0},
+    {2, 1, {"--n"}, {34}, 0},
+    {2, 2, {"--n"}, {34}, 0},
+    {3, 1, {"--n"}, {200}, 0},
+    {3, 2, {"--n"}, {200}, 0},
+    {4, 1, {"--height"}, {139}, 2047},
+    {4, 2, {"--height"}, {139}, 2047},
+    {5, 1, {"--ranges", "--ids"}, {187, 1000}, 100000},
+    {5, 2, {"--ranges", "--ids"}, {187, 1000}, 10000},
+    {6, 1, {"--problems"}, {1000}, 1100}, // Lines of at most 4096 bytes
+    {6, 2, {"--problems"}, {1000}, 1100},
+    {7, 1, {"--height"}, {142}, 1023},
+    {7, 2, {"--height"}, {142}, 2047},
+    {8, 1, {"--n"}, {1000}, 0},
+    {8, 2, {"--n"}, {1000}, 0},
+    {9, 1, {"--n"}, {496}, 0},
+    {9, 2, {"--n"}, {496}, 0},
+    {10, 1, {"--machines"}, {171}, 0},
+    {10, 2, {"--machines"}, {171}, 0},
+    {11, 1, {"--nodes", "--edges"}, {575, 1642}, 0},
+    {11, 2, {"--nodes", "--edges"}, {575, 1642}, 0},
+};
+#define NUM_TARGETS ((int)(sizeof(TARGETS) / sizeof(TARGETS[0])))
+
+/**
+ * Samples of one phase, in milliseconds.
+ */
+typedef struct {
+  char name[64];
+  int count;
+  double ms[];
+} Series;
+
+typedef struct {
+  const char *format;
+  int first_row; // No JSON separator needed yet
+} Output;
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * Runs argv with stdin from in_path and stdout to out_path, and with
+ * AOC_PHASE_FILE set to phase_path (if not NULL).
+ * @return The exit status (-1 if it didn't exit normally); *ms is the wall
+ * time from fork to exit, *rss_kb the child's peak RSS.
+ */
+static int run(char *const argv[], const char *in_path, const char *out_path,
+               const char *phase_path, double *ms, long *rss_kb) {
+  double start = now_ms();
+  pid_t pid = fork();
+  if (pid < 0)
+    return -1;
+  if (pid == 0) {
+    int in = in_path ? open(in_path, O_RDONLY) : open("/dev/null", O_RDONLY);
+    int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (in < 0 || out < 0)
+      _exit(127);
+    dup2(in, 0);
+    dup2(out, 1);
+    if (phase_path)
+      setenv("AOC_PHASE_FILE", phase_path, 1);
+    execv(argv[0], argv);
+    fprintf(stderr, "Error: cannot run '%s': %s\n", argv[0], strerror(errno));
+    _exit(127);
+  }
+  int status;
+  struct rusage ru;
+  while (wait4(pid, &status, 0, &ru) < 0)
+    if (errno != EINTR)
+      return -1;
+  *ms = now_ms() - start;
+  *rss_kb = ru.ru_maxrss;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static Series *find_series(Series **series, int *num_series, const char *name,
+                           int reps) {
+  for (int i = 0; i < *num_series; i++)
+    if (strcmp(series[i]->name, name) == 0)
+      return series[i];
+  if (*num_series == MAX_SERIES)
+    return NULL;
+  Series *s = malloc(sizeof(Series) + reps * sizeof(double));
+  snprintf(s->name, sizeof(s->name), "%s", name);
+  s->count = 0;
+  series[(*num_series)++] = s;
+  return s;
+}
+
+/**
+ * Adds the phase lines of one run ("phase<TAB>name<TAB>count<TAB>ns") to the
+ * series. Other lines (hardware counters) are skipped.
+ */
+static void read_phases(const char *path, Series **series, int *num_series,
+                        int reps) {
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return;
+  char line[256], name[64];
+  long long count, ns;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "phase\t%63s\t%lld\t%lld", name, &count, &ns) != 3)
+      continue;
+    Series *s = find_series(series, num_series, name, reps);
+    if (s)
+      s->ms[s->count++] = ns / 1e6;
+  }
+  fclose(f);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static void print_row(Output *out, const Target *t, double scale,
+                      long long size, long long bytes, long rss_kb,
+                      Series *s) {
+  qsort(s->ms, s->count, sizeof(double), compare_doubles);
+  double median = s->count % 2 ? s->ms[s->count / 2]
+                               : (s->ms[s->count / 2 - 1] +
+                                  s->ms[s->count / 2]) / 2;
+  int rank = (int)ceil(0.99 * s->count);
+  double p99 = s->ms[rank > 0 ? rank - 1 : 0];
+
+  if (strcmp(out->format, "json") == 0) {
+    printf("%s\n  {\"day\": %d, \"part\": %d, \"scale\": %g, \"size\": %lld, "
+           "\"bytes\": %lld, \"phase\": \"%s\", \"runs\": %d, "
+           "\"median_ms\": %.3f, \"p99_ms\": %.3f, \"peak_rss_kb\": %ld}",
+           out->first_row ? "" : ",", t->day, t->part, scale, size, bytes,
+           s->name, s->count, median, p99, rss_kb);
+  } else {
+    printf("%d,%d,%g,%lld,%lld,%s,%d,%.3f,%.3f,%ld\n", t->day, t->part,
+           scale, size, bytes, s->name, s->count, median, p99, rss_kb);
+  }
+  out->first_row = 0;
+  fflush(stdout);
+}
+
+/**
+ * Generates (once) the input of day t->day at the given scale.
+ * @return 0 on success, -1 if the generator failed.
+ */
+static int generate(const char *bin, const char *work, const Target *t,
+                    double scale, long long seed, char *path,
+                    long long *bytes) {
+  snprintf(path, PATH_LEN, "%s/day%d_%g.txt", work, t->day, scale);
+  struct stat st;
+  if (stat(path, &st) == 0) {
+    *bytes = st.st_size;
+    return 0;
+  }
+
+  char gen[PATH_LEN], values[2][32], seed_str[32];
+  snprintf(gen, sizeof(gen), "%s/gen_day%d", bin, t->day);
+  snprintf(seed_str, sizeof(seed_str), "%lld", seed);
+  char *argv[8] = {gen};
+  int argc = 1;
+  for (int i = 0; i < 2 && t->opt[i]; i++) {
+    long long v = llround(t->base[i] * scale);
+    snprintf(values[i], sizeof(values[i]), "%lld", v > 1 ? v : 1);
+    argv[argc++] = (char *)t->opt[i];
+    argv[argc++] = values[i];
+  }
+  argv[argc++] = "--seed";
+  argv[argc++] = seed_str;
+  argv[argc] = NULL;
+
+  double ms;
+  long rss_kb;
+  if (run(argv, NULL, path, NULL, &ms, &rss_kb) != 0 || stat(path, &st) != 0) {
+    unlink(path);
+    return -1;
+  }
+  *bytes = st.st_size;
+  return 0;
+}
+
+static void bench_target(const char *bin, const char *work, const Target *t,
+                         double scale, int reps, long long seed,
+                         Output *out) {
+  long long size = llround(t->base[0] * scale);
+  if (size < 1)
+    size = 1;
+  if (t->limit && size > t->limit) {
+    fprintf(stderr, "Skipping day %d part %d at scale %g: size %lld is over "
+                    "the solver's limit of %lld\n",
+            t->day, t->part, scale, size, t->limit);
+    return;
+  }
+
+  char input[PATH_LEN];
+  long long bytes;
+  if (generate(bin, work, t, scale, seed, input, &bytes) != 0) {
+    fprintf(stderr, "Error: generating the day %d input failed\n", t->day);
+    return;
+  }
+
+  char solver[PATH_LEN], phases[PATH_LEN], output[PATH_LEN];
+  snprintf(solver, sizeof(solver), "%s/day%d_part%d", bin, t->day, t->part);
+  snprintf(phases, sizeof(phases), "%s/phases.txt", work);
+  snprintf(output, sizeof(output), "%s/output.txt", work);
+  char *argv[] = {solver, NULL};
+
+  Series *series[MAX_SERIES];
+  int num_series = 0;
+  Series *total = find_series(series, &num_series, "total", reps);
+  long peak_rss_kb = 0;
+  for (int r = 0; r < reps; r++) {
+    unlink(phases);
+    double ms;
+    long rss_kb;
+    int status = run(argv, input, output, phases, &ms, &rss_kb);
+    if (status != 0) {
+      fprintf(stderr, "Error: day %d part %d failed (status %d) on %s\n",
+              t->day, t->part, status, input);
+      continue;
+    }
+    total->ms[total->count++] = ms;
+    if (rss_kb > peak_rss_kb)
+      peak_rss_kb = rss_kb;
+    read_phases(phases, series, &num_series, reps);
+  }
+
+  for (int i = 0; i < num_series; i++) {
+    if (series[i]->count > 0)
+      print_row(out, t, scale, size, bytes, peak_rss_kb, series[i]);
+    free(series[i]);
+  }
+}
+
+int main(int argc, char **argv) {
+  int reps = 11;
+  long long seed = 1;
+  const char *scales_arg = "0.25,0.5,1,2,4";
+  const char *only = NULL;
+  const char *bin = NULL;
+  Output out = {"csv", 1};
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+      reps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--scales") == 0 && i + 1 < argc)
+      scales_arg = argv[++i];
+    else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+      out.format = argv[++i];
+    else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc)
+      only = argv[++i];
+    else if (strcmp(argv[i], "--bin") == 0 && i + 1 < argc)
+      bin = argv[++i];
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = atoll(argv[++i]);
+    else {
+      fprintf(stderr, "usage: bench [--reps N] [--scales 0.5,1,2] "
+                      "[--format csv|json] [--only dayN[/partM]] "
+                      "[--bin DIR] [--seed S]\n");
+      return 1;
+    }
+  }
+  if (reps < 1)
+    reps = 1;
+
+  double scales[MAX_SCALES];
+  int num_scales = 0;
+  char *list = strdup(scales_arg);
+  for (char *tok = strtok(list, ","); tok && num_scales < MAX_SCALES;
+       tok = strtok(NULL, ","))
+    if (atof(tok) > 0)
+      scales[num_scales++] = atof(tok);
+  free(list);
+
+  char bin_dir[PATH_LEN];
+  if (!bin) {
+    snprintf(bin_dir, sizeof(bin_dir), "%s", argv[0]);
+    char *slash = strrchr(bin_dir, '/');
+    if (slash)
+      *slash = '\0';
+    else
+      strcpy(bin_dir, ".");
+    bin = bin_dir;
+  }
+
+  char work[] = "/tmp/aoc-bench-XXXXXX";
+  if (!mkdtemp(work)) {
+    fprintf(stderr, "Error: cannot create a work directory: %s\n",
+            strerror(errno));
+    return 1;
+  }
+
+  if (strcmp(out.format, "json") == 0)
+    printf("[");
+  else
+    printf("day,part,scale,size,bytes,phase,runs,median_ms,p99_ms,"
+           "peak_rss_kb\n");
+
+  for (int i = 0; i < NUM_TARGETS; i++) {
+    const Target *t = &TARGETS[i];
+    if (only) {
+      char day[16], day_part[32];
+      snprintf(day, sizeof(day), "day%d", t->day);
+      snprintf(day_part, sizeof(day_part), "day%d/part%d", t->day, t->part);
+      if (strcmp(only, day) != 0 && strcmp(only, day_part) != 0)
+        continue;
+    }
+    for (int s = 0; s < num_scales; s++)
+      bench_target(bin, work, t, scales[s], reps, seed, &out);
+  }
+
+  if (strcmp(out.format, "json") == 0)
+    printf("\n]\n");
+
+  // Remove the generated inputs
+  char cmd[PATH_LEN + 16];
+  snprintf(cmd, sizeof(cmd), "rm -rf '%s'", work);
+  return system(cmd) == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Builds the benchmark: every solver with phase markers (-DAOC_PHASES) as
+# dayN_partM, every input generator as gen_dayN, and the bench runner, all
+# into one directory.
+# Usage: build.sh [DIR]   (default: tools/bench/bin)
+# CFLAGS is added to the solver flags, e.g. CFLAGS=-DAOC_COUNTERS build.sh
+# for hardware counters or -DAOC_ALLOCS for the heap and peak RSS report in
+# the phase output (see common/phase.h).
+set -e
+
+root=$(cd "$(dirname "$0")/../.." && pwd)
+out=${1:-"$root/tools/bench/bin"}
+cc=${CC:-gcc}
+mkdir -p "$out"
+
+for src in "$root"/day*/part*/*.c; do
+  part=$(basename "$(dirname "$src")")
+  day=$(basename "$(dirname "$(dirname "$src")")")
+  $cc -O2 -march=native -pthread -DAOC_PHASES $CFLAGS \
+    -o "$out/${day}_$part" "$src" -lm
+done
+for src in "$root"/tools/gen/gen_day*.c; do
+  $cc -O2 -o "$out/$(basename "$src" .c)" "$src"
+done
+$cc -O2 -o "$out/bench" "$root/tools/bench/bench.c" -lm
+
+echo "Built into $out; run $out/bench"
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Builds the differential checker: the reference solvers as dayN_partM, every
+# input generator as gen_dayN, and check, all into one directory.
+# Usage: build.sh [DIR]   (default: tools/check/bin)
+# A solver whose algorithm was replaced keeps its original version in
+# tools/check/reference/dayN_partM.c, and that is the reference; the others
+# are built from their current source. Build the engines to check into
+# another directory, with the same names, and pass it as check --engine DIR.
+set -e
+
+root=$(cd "$(dirname "$0")/../.." && pwd)
+out=${1:-"$root/tools/check/bin"}
+cc=${CC:-gcc}
+mkdir -p "$out"
+
+for src in "$root"/day*/part*/*.c; do
+  part=$(basename "$(dirname "$src")")
+  day=$(basename "$(dirname "$(dirname "$src")")")
+  ref="$root/tools/check/reference/${day}_$part.c"
+  [ -f "$ref" ] && src=$ref
+  $cc -O2 -march=native -pthread -o "$out/${day}_$part" "$src" -lm
+done
+for src in "$root"/tools/gen/gen_day*.c; do
+  $cc -O2 -o "$out/$(basename "$src" .c)" "$src"
+done
+$cc -O2 -o "$out/check" "$root/tools/check/check.c"
+
+echo "Built into $out; run $out/check --engine DIR"
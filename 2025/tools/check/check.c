@@ -0,0 +1,548 @@
+/**
+ * Differential checker: runs reference solvers against the engines under
+ * test on many small random inputs, and reports any input where they
+ * disagree.
+ * * The references are the straightforward solvers the faster engines
+ * replaced: days 1, 9, 10 and 11 keep their original sources in
+ * tools/check/reference/ (dayN_partM.c, built in their place by build.sh).
+ * The other days still run their original algorithm, so their reference is
+ * the current source, which only catches differences between two builds
+ * (other flags, another checkout).
+ * * Each case generates an input with tools/gen (random sizes up to the small
+ * limits in TARGETS, random seed), runs the reference and the engine on it,
+ * and compares their exit status and stdout byte for byte. Inputs on which
+ * the reference itself fails are outside the puzzle's domain and are skipped.
+ * * A mismatching input is shrunk to a minimal reproducer (delta debugging
+ * over its lines, or over the comma separated ranges of day 2): pieces are
+ * removed for as long as the two still disagree with the reference
+ * succeeding. The reproducer is written to --out as dayN_partM-<seed>.txt,
+ * both outputs for it go to stderr, and checking moves on to the next
+ * solver.
+ * * Every run (generator, reference or engine) is killed after --timeout
+ * seconds (default 10). A timeout is a failure: the input is kept in --out
+ * as for a mismatch (unless the generator hung: its command line is
+ * printed) and checking moves on to the next solver.
+ * * Output, one row per solver, on stdout:
+ * day,part,cases,skipped,mismatches,timeouts,ref_ms,engine_ms,ratio,
+ * ref_mbps,engine_mbps
+ * ratio is ref_ms / engine_ms, above 1 when the engine is faster. The times
+ * are whole runs, process startup included, so on inputs this small they
+ * mostly compare startup; raise --scale for throughput on larger inputs.
+ * * Build with build.sh, then:
+ * check --engine DIR [--ref DIR] [--only dayN[/partM]] [--cases N]
+ *       [--scale F] [--seed S] [--timeout SEC] [--out DIR]
+ * Both directories hold dayN_partM binaries, as written by build.sh (which
+ * also builds the references and generators into its output, the default
+ * for --ref). The exit status is 1 if any solver mismatched or timed out.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../gen/gen.h"
+
+#define PATH_LEN 4096
+#define TIMED_OUT -2 // run() status of a process killed for its time
+#define TARGET_OPTS 4 // Generator options per target
+#define SIZE_OPTS 2   // Of which the first ones set the size
+
+static double timeout_s = 10; // --timeout, per run
+
+/**
+ * One solver and the size of its inputs: each case draws one fraction of
+ * the way from min[] to max[] (scaled by --scale) for the first SIZE_OPTS
+ * generator options in opt[]. Any further options are shape rather than
+ * size: each draws its own value and ignores --scale.
+ */
+typedef struct {
+  int day;
+  int part;
+  const char *opt[TARGET_OPTS];
+  long long min[TARGET_OPTS];
+  long long max[TARGET_OPTS];
+} Target;
+
+static const Target TARGETS[] = {
+    {1, 1, {"--n"}, {1}, {60}},
+    {1, 2, {"--n"}, {1}, {60}},
+    {2, 1, {"--n"}, {1}, {8}},
+    {2, 2, {"--n"}, {1}, {8}},
+    {3, 1, {"--n"}, {1}, {20}},
+    {3, 2, {"--n"}, {1}, {20}},
+    {4, 1, {"--width", "--height"}, {1, 1}, {24, 24}},
+    {4, 2, {"--width", "--height"}, {1, 1}, {24, 24}},
+    {5, 1, {"--ranges", "--ids"}, {1, 1}, {20, 30}},
+    {5, 2, {"--ranges", "--ids"}, {1, 1}, {20, 30}},
+    {6, 1, {"--problems"}, {1}, {20}},
+    {6, 2, {"--problems"}, {1}, {20}},
+    {7, 1, {"--width", "--height"}, {3, 2}, {25, 24}},
+    {7, 2, {"--width", "--height"}, {3, 2}, {25, 24}},
+    {8, 1, {"--n"}, {2}, {60}},
+    {8, 2, {"--n"}, {2}, {60}},
+    {9, 1, {"--n"}, {4}, {40}},
+    {9, 2, {"--n"}, {4}, {40}},
+    {10, 1, {"--machines"}, {1}, {6}},
+    // The reference sweeps each free variable over 0..200, so three of them
+    // already take seconds per machine (as do duplicate buttons, common with
+    // under 4 lights), and it misses optima that press one above 200
+    {10, 2, {"--machines", "--free", "--max-press", "--lights"},
+     {1, -2, 1, 4}, {6, 2, 60, 16}},
+    {11, 1, {"--nodes", "--edges"}, {5, 8}, {40, 100}},
+    {11, 2, {"--nodes", "--edges"}, {5, 8}, {40, 100}},
+};
+#define NUM_TARGETS ((int)(sizeof(TARGETS) / sizeof(TARGETS[0])))
+
+typedef struct {
+  char *data;
+  size_t len;
+} Buffer;
+
+// One solver run
+typedef struct {
+  int status;
+  Buffer out;
+  double ms;
+} Result;
+
+// Where the inputs and outputs of a case live
+typedef struct {
+  const char *ref;    // Reference binary
+  const char *engine; // Engine binary
+  char input[PATH_LEN];
+  char output[PATH_LEN];
+} Pair;
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int read_file(const char *path, Buffer *b) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+  size_t cap = 4096, n;
+  b->data = malloc(cap);
+  b->len = 0;
+  while ((n = fread(b->data + b->len, 1, cap - b->len, f)) > 0) {
+    b->len += n;
+    if (b->len == cap)
+      b->data = realloc(b->data, cap *= 2);
+  }
+  fclose(f);
+  return 0;
+}
+
+static int write_file(const char *path, const char *data, size_t len) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return -1;
+  int ok = fwrite(data, 1, len, f) == len;
+  return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+/**
+ * Runs argv with stdin from in_path (or /dev/null) and stdout to out_path;
+ * stderr is discarded. It is killed after timeout_s seconds. SIGCHLD is
+ * blocked (see main) and waited for with sigtimedwait, so the exit is seen
+ * as soon as it happens and the timing stays exact.
+ * @return The exit status (-1 if it didn't exit normally, TIMED_OUT if it
+ * was killed); *ms is the wall time from fork to exit.
+ */
+static int run(char *const argv[], const char *in_path, const char *out_path,
+               double *ms) {
+  sigset_t chld;
+  sigemptyset(&chld);
+  sigaddset(&chld, SIGCHLD);
+  double start = now_ms();
+  pid_t pid = fork();
+  if (pid < 0)
+    return -1;
+  if (pid == 0) {
+    sigprocmask(SIG_UNBLOCK, &chld, NULL);
+    setpgid(0, 0); // Its own group, so a timeout kills its children too
+    int in = in_path ? open(in_path, O_RDONLY) : open("/dev/null", O_RDONLY);
+    int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int err = open("/dev/null", O_WRONLY);
+    if (in < 0 || out < 0 || err < 0)
+      _exit(127);
+    dup2(in, 0);
+    dup2(out, 1);
+    dup2(err, 2);
+    execv(argv[0], argv);
+    _exit(127);
+  }
+  int status;
+  for (;;) {
+    pid_t done = waitpid(pid, &status, WNOHANG);
+    if (done == pid)
+      break;
+    if (done < 0 && errno != EINTR)
+      return -1;
+    double left = timeout_s * 1e3 - (now_ms() - start);
+    if (left <= 0) {
+      kill(-pid, SIGKILL);
+      while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        ;
+      *ms = now_ms() - start;
+      return TIMED_OUT;
+    }
+    long long ns = (long long)(left * 1e6);
+    struct timespec ts = {ns / 1000000000, ns % 1000000000};
+    sigtimedwait(&chld, NULL, &ts);
+  }
+  *ms = now_ms() - start;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void run_solver(const char *solver, const Pair *p, Result *r) {
+  char *argv[] = {(char *)solver, NULL};
+  r->status = run(argv, p->input, p->output, &r->ms);
+  if (read_file(p->output, &r->out) != 0)
+    r->out = (Buffer){calloc(1, 1), 0};
+}
+
+static int same(const Result *a, const Result *b) {
+  return a->status == b->status && a->out.len == b->out.len &&
+         memcmp(a->out.data, b->out.data, a->out.len) == 0;
+}
+
+/**
+ * Runs both solvers on the input in memory.
+ * @return 1 if the reference succeeds and the engine disagrees with it (a
+ * timeout doesn't count: shrinking looks for wrong answers).
+ */
+static int mismatch(const Pair *p, const char *data, size_t len) {
+  if (write_file(p->input, data, len) != 0)
+    return 0;
+  Result ref, engine;
+  run_solver(p->ref, p, &ref);
+  int differs = 0;
+  if (ref.status == 0) {
+    run_solver(p->engine, p, &engine);
+    differs = engine.status != TIMED_OUT && !same(&ref, &engine);
+    free(engine.out.data);
+  }
+  free(ref.out.data);
+  return differs;
+}
+
+/**
+ * Joins the pieces whose keep flag is set with sep, ending with a newline.
+ * @return The length written to out.
+ */
+static size_t join(char **pieces, size_t *lens, const char *keep, int n,
+                   char sep, char *out) {
+  size_t len = 0;
+  int first = 1;
+  for (int i = 0; i < n; i++) {
+    if (!keep[i])
+      continue;
+    if (!first)
+      out[len++] = sep;
+    memcpy(out + len, pieces[i], lens[i]);
+    len += lens[i];
+    first = 0;
+  }
+  out[len++] = '\n';
+  return len;
+}
+
+/**
+ * Shrinks a mismatching input in place (ddmin): removes ever smaller runs of
+ * pieces while the mismatch persists. Pieces are lines, or the ranges of a
+ * single comma separated line.
+ */
+static void shrink(const Pair *p, Buffer *input) {
+  size_t len = input->len;
+  while (len > 0 && input->data[len - 1] == '\n')
+    len--;
+  char sep = memchr(input->data, '\n', len) ? '\n' : ',';
+
+  int n = 1;
+  for (size_t i = 0; i < len; i++)
+    n += input->data[i] == sep;
+  char **pieces = malloc(n * sizeof(char *));
+  size_t *lens = malloc(n * sizeof(size_t));
+  char *keep = malloc(n), *trial = malloc(n);
+  char *text = malloc(input->len + 1);
+  for (int i = 0, k = 0; k < n; k++) {
+    pieces[k] = input->data + i;
+    const char *end = memchr(pieces[k], sep, len - i);
+    lens[k] = end ? (size_t)(end - pieces[k]) : len - i;
+    i += lens[k] + 1;
+    keep[k] = 1;
+  }
+
+  int kept = n, chunks = 2;
+  while (kept >= 2) {
+    int removed = 0;
+    // Try without each of the chunks of kept pieces
+    for (int c = 0; c < chunks && !removed; c++) {
+      int lo = (int)((long long)kept * c / chunks);
+      int hi = (int)((long long)kept * (c + 1) / chunks);
+      memcpy(trial, keep, n);
+      for (int i = 0, rank = 0; i < n; i++) {
+        if (!keep[i])
+          continue;
+        if (rank >= lo && rank < hi)
+          trial[i] = 0;
+        rank++;
+      }
+      size_t text_len = join(pieces, lens, trial, n, sep, text);
+      if (mismatch(p, text, text_len)) {
+        memcpy(keep, trial, n);
+        kept -= hi - lo;
+        chunks = chunks > 2 ? chunks - 1 : 2;
+        removed = 1;
+      }
+    }
+    if (!removed) {
+      if (chunks >= kept)
+        break;
+      chunks = chunks * 2 < kept ? chunks * 2 : kept;
+    }
+  }
+
+  size_t text_len = join(pieces, lens, keep, n, sep, text);
+  free(input->data);
+  input->data = text;
+  input->len = text_len;
+  free(pieces);
+  free(lens);
+  free(keep);
+  free(trial);
+}
+
+// Writes the input that failed; path receives its name
+static void keep_input(const Target *t, const char *out_dir, long long seed,
+                       const Buffer *input, char *path, size_t size) {
+  snprintf(path, size, "%s/day%d_part%d-%lld.txt", out_dir, t->day, t->part,
+           seed);
+  write_file(path, input->data, input->len);
+}
+
+// Writes the reproducer and both outputs for it
+static void report(const Pair *p, const Target *t, const char *out_dir,
+                   long long seed, const Buffer *input) {
+  char path[PATH_LEN + 64];
+  keep_input(t, out_dir, seed, input, path, sizeof(path));
+
+  write_file(p->input, input->data, input->len);
+  Result ref, engine;
+  run_solver(p->ref, p, &ref);
+  run_solver(p->engine, p, &engine);
+  fprintf(stderr,
+          "Mismatch: day %d part %d, reproducer %s (%zu bytes)\n"
+          "reference (status %d):\n%.*s"
+          "engine (status %d):\n%.*s",
+          t->day, t->part, path, input->len, ref.status, (int)ref.out.len,
+          ref.out.data, engine.status, (int)engine.out.len, engine.out.data);
+  free(ref.out.data);
+  free(engine.out.data);
+}
+
+/**
+ * Generates the input of one case at work/input.txt.
+ * @return 0 on success, -1 if the generator rejected the sizes, TIMED_OUT if
+ * it hung (its command line is then printed).
+ */
+static int generate(const char *gen_dir, const Target *t, Rng *rng,
+                    double scale, long long seed, const Pair *p) {
+  char gen[PATH_LEN + 32], values[TARGET_OPTS][32], seed_str[32];
+  snprintf(gen, sizeof(gen), "%s/gen_day%d", gen_dir, t->day);
+  snprintf(seed_str, sizeof(seed_str), "%lld", seed);
+  char *argv[2 * TARGET_OPTS + 4] = {gen};
+  int argc = 1;
+  double f = rng_unit(rng);
+  for (int i = 0; i < TARGET_OPTS && t->opt[i]; i++) {
+    int sized = i < SIZE_OPTS;
+    if (!sized)
+      f = rng_unit(rng);
+    long long max = sized ? (long long)(t->max[i] * scale) : t->max[i];
+    long long v = t->min[i] + (long long)(f * (max - t->min[i] + 1));
+    snprintf(values[i], sizeof(values[i]), "%lld", v > max ? max : v);
+    argv[argc++] = (char *)t->opt[i];
+    argv[argc++] = values[i];
+  }
+  argv[argc++] = "--seed";
+  argv[argc++] = seed_str;
+  argv[argc] = NULL;
+  double ms;
+  int status = run(argv, NULL, p->input, &ms);
+  if (status == TIMED_OUT) {
+    fprintf(stderr, "Timeout: day %d part %d, generator ran over %g s:",
+            t->day, t->part, timeout_s);
+    for (int i = 0; i < argc; i++)
+      fprintf(stderr, " %s", argv[i]);
+    fprintf(stderr, "\n");
+    return TIMED_OUT;
+  }
+  return status == 0 ? 0 : -1;
+}
+
+/**
+ * Checks one solver on cases random inputs and prints its row.
+ * @return 1 if it mismatched or timed out, else 0.
+ */
+static int check_target(const char *ref_dir, const char *engine_dir,
+                        const char *work, const char *out_dir,
+                        const Target *t, int cases, double scale,
+                        long long seed) {
+  char ref[PATH_LEN + 32], engine[PATH_LEN + 32];
+  snprintf(ref, sizeof(ref), "%s/day%d_part%d", ref_dir, t->day, t->part);
+  snprintf(engine, sizeof(engine), "%s/day%d_part%d", engine_dir, t->day,
+           t->part);
+  Pair p = {.ref = ref, .engine = engine};
+  snprintf(p.input, sizeof(p.input), "%s/input.txt", work);
+  snprintf(p.output, sizeof(p.output), "%s/output.txt", work);
+
+  Rng rng;
+  rng_seed(&rng, seed * 100 + t->day * 2 + t->part);
+  int checked = 0, skipped = 0, mismatches = 0, timeouts = 0;
+  double ref_ms = 0, engine_ms = 0, bytes = 0;
+  for (int c = 0; c < cases && !mismatches && !timeouts; c++) {
+    long long case_seed = (long long)(rng_next(&rng) >> 33);
+    Buffer input;
+    int generated = generate(ref_dir, t, &rng, scale, case_seed, &p);
+    if (generated == TIMED_OUT) {
+      timeouts++;
+      continue;
+    }
+    if (generated != 0 || read_file(p.input, &input) != 0) {
+      skipped++;
+      continue;
+    }
+
+    Result r, e;
+    run_solver(ref, &p, &r);
+    if (r.status == TIMED_OUT) {
+      timeouts++;
+      char path[PATH_LEN + 64];
+      keep_input(t, out_dir, case_seed, &input, path, sizeof(path));
+      fprintf(stderr,
+              "Timeout: day %d part %d, reference ran over %g s on %s\n",
+              t->day, t->part, timeout_s, path);
+    } else if (r.status != 0) {
+      skipped++;
+    } else {
+      run_solver(engine, &p, &e);
+      checked++;
+      ref_ms += r.ms;
+      engine_ms += e.ms;
+      bytes += input.len;
+      if (e.status == TIMED_OUT) {
+        timeouts++;
+        char path[PATH_LEN + 64];
+        keep_input(t, out_dir, case_seed, &input, path, sizeof(path));
+        fprintf(stderr,
+                "Timeout: day %d part %d, engine ran over %g s on %s\n",
+                t->day, t->part, timeout_s, path);
+      } else if (!same(&r, &e)) {
+        mismatches++;
+        shrink(&p, &input);
+        report(&p, t, out_dir, case_seed, &input);
+      }
+      free(e.out.data);
+    }
+    free(r.out.data);
+    free(input.data);
+  }
+
+  printf("%d,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", t->day, t->part,
+         checked, skipped, mismatches, timeouts, ref_ms, engine_ms,
+         engine_ms > 0 ? ref_ms / engine_ms : 0,
+         ref_ms > 0 ? bytes / 1e3 / ref_ms : 0,
+         engine_ms > 0 ? bytes / 1e3 / engine_ms : 0);
+  fflush(stdout);
+  return mismatches > 0 || timeouts > 0;
+}
+
+int main(int argc, char **argv) {
+  int cases = 1000;
+  long long seed = 1;
+  double scale = 1;
+  const char *ref = NULL, *engine = NULL, *only = NULL, *out_dir = ".";
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc)
+      engine = argv[++i];
+    else if (strcmp(argv[i], "--ref") == 0 && i + 1 < argc)
+      ref = argv[++i];
+    else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc)
+      only = argv[++i];
+    else if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc)
+      cases = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+      scale = atof(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = atoll(argv[++i]);
+    else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+      timeout_s = atof(argv[++i]);
+    else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+      out_dir = argv[++i];
+    else {
+      engine = NULL;
+      break;
+    }
+  }
+  if (!engine || cases < 1 || scale <= 0 || timeout_s <= 0) {
+    fprintf(stderr, "usage: check --engine DIR [--ref DIR] "
+                    "[--only dayN[/partM]] [--cases N] [--scale F] "
+                    "[--seed S] [--timeout SEC] [--out DIR]\n");
+    return 1;
+  }
+
+  char ref_dir[PATH_LEN];
+  if (!ref) {
+    snprintf(ref_dir, sizeof(ref_dir), "%s", argv[0]);
+    char *slash = strrchr(ref_dir, '/');
+    if (slash)
+      *slash = '\0';
+    else
+      strcpy(ref_dir, ".");
+    ref = ref_dir;
+  }
+
+  char work[] = "/tmp/aoc-check-XXXXXX";
+  if (!mkdtemp(work)) {
+    fprintf(stderr, "Error: cannot create a work directory: %s\n",
+            strerror(errno));
+    return 1;
+  }
+
+  // Children are reaped with sigtimedwait in run()
+  sigset_t chld;
+  sigemptyset(&chld);
+  sigaddset(&chld, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &chld, NULL);
+
+  printf("day,part,cases,skipped,mismatches,timeouts,ref_ms,engine_ms,ratio,"
+         "ref_mbps,engine_mbps\n");
+  int failed = 0;
+  for (int i = 0; i < NUM_TARGETS; i++) {
+    const Target *t = &TARGETS[i];
+    if (only) {
+      char day[16], day_part[32];
+      snprintf(day, sizeof(day), "day%d", t->day);
+      snprintf(day_part, sizeof(day_part), "day%d/part%d", t->day, t->part);
+      if (strcmp(only, day) != 0 && strcmp(only, day_part) != 0)
+        continue;
+    }
+    failed |= check_target(ref, engine, work, out_dir, t, cases, scale, seed);
+  }
+
+  char cmd[PATH_LEN + 16];
+  snprintf(cmd, sizeof(cmd), "rm -rf '%s'", work);
+  if (system(cmd) != 0)
+    fprintf(stderr, "Warning: cannot remove %s\n", work);
+  return failed;
+}
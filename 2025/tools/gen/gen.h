@@ -0,0 +1,118 @@
+/**
+ * Shared helpers for the input generators in this directory.
+ * * Every generator writes one puzzle input to stdout. Sizes are set with
+ * options (defaults match the size of the real puzzle input), and --seed
+ * makes the output reproducible: the same seed and options always produce
+ * the same bytes, on any platform.
+ * * Build: gcc -O2 -o gen_day8 gen_day8.c
+ * Run:   ./gen_day8 --n 100000 --seed 7 > big.txt
+ */
+#ifndef AOC_GEN_H
+#define AOC_GEN_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * xoshiro256** seeded through splitmix64.
+ */
+typedef struct {
+  uint64_t s[4];
+} Rng;
+
+static inline uint64_t splitmix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static inline void rng_seed(Rng *r, uint64_t seed) {
+  for (int i = 0; i < 4; i++)
+    r->s[i] = splitmix64(&seed);
+}
+
+static inline uint64_t rng_next(Rng *r) {
+  uint64_t *s = r->s;
+  uint64_t x = s[1] * 5;
+  uint64_t result = ((x << 7) | (x >> 57)) * 9;
+  uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = (s[3] << 45) | (s[3] >> 19);
+  return result;
+}
+
+/**
+ * Uniform integer in [lo, hi] (inclusive), without modulo bias.
+ */
+static inline long long rng_range(Rng *r, long long lo, long long hi) {
+  uint64_t span = (uint64_t)(hi - lo) + 1;
+  if (span == 0) // Full 64-bit range
+    return (long long)rng_next(r);
+  uint64_t limit = UINT64_MAX - UINT64_MAX % span;
+  uint64_t x;
+  do {
+    x = rng_next(r);
+  } while (x >= limit);
+  return lo + (long long)(x % span);
+}
+
+/**
+ * Uniform real in [0, 1).
+ */
+static inline double rng_unit(Rng *r) {
+  return (rng_next(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Fisher-Yates shuffle of n ints.
+ */
+static inline void rng_shuffle(Rng *r, int *a, int n) {
+  for (int i = n - 1; i > 0; i--) {
+    int j = (int)rng_range(r, 0, i);
+    int tmp = a[i];
+    a[i] = a[j];
+    a[j] = tmp;
+  }
+}
+
+/**
+ * Option lookup: "--name value". Returns def if the option is absent.
+ */
+static inline long long opt_int(int argc, char **argv, const char *name,
+                                long long def) {
+  for (int i = 1; i + 1 < argc; i++)
+    if (strcmp(argv[i], name) == 0)
+      return strtoll(argv[i + 1], NULL, 10);
+  return def;
+}
+
+static inline double opt_real(int argc, char **argv, const char *name,
+                              double def) {
+  for (int i = 1; i + 1 < argc; i++)
+    if (strcmp(argv[i], name) == 0)
+      return strtod(argv[i + 1], NULL);
+  return def;
+}
+
+/**
+ * Prints usage and exits if --help is given, then seeds r from --seed.
+ */
+static inline void gen_init(Rng *r, int argc, char **argv,
+                            const char *usage) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      fputs(usage, stdout);
+      exit(0);
+    }
+  }
+  rng_seed(r, (uint64_t)opt_int(argc, argv, "--seed", 1));
+}
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * Input generator for Day 1 (Secret Entrance): one rotation per line,
+ * "L68" or "R12".
+ * * Options:
+ * --n N       Number of rotations (default 4732)
+ * --max D     Largest rotation distance (default 999)
+ * --seed S    Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day1 [--n N] [--max D] [--seed S]\n");
+  long long n = opt_int(argc, argv, "--n", 4732);
+  long long max = opt_int(argc, argv, "--max", 999);
+
+  for (long long i = 0; i < n; i++)
+    printf("%c%lld\n", rng_range(&rng, 0, 1) ? 'R' : 'L',
+           rng_range(&rng, 1, max));
+  return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * Input generator for Day 10 (Factory): one machine per line,
+ * "[.##.] (0,3) (1,2) ... {3,5,4}".
+ * * Every machine is solvable: the joltage targets are A x for a random
+ * press count vector x (0..max-press per button), and the light pattern is
+ * the parity of A y for a random 0/1 vector y, where A is the machine's
+ * button/light matrix.
+ * * The number of free variables of the part 2 system is buttons - rank,
+ * which is buttons - lights whenever the buttons span all lights; --free
+ * sets that difference directly (the real input has -2..3).
+ * * Options:
+ * --machines N    Number of machines (default 171)
+ * --lights L      Most lights per machine, at most 64 (default 10)
+ * --free F        Buttons minus lights (default: random in -2..3)
+ * --max-press P   Most presses of one button in x (default 40)
+ * --seed S        Random seed (default 1)
+ */
+#include "gen.h"
+
+#define MAX_LIGHTS 64
+#define MAX_BUTTONS 128 // Part 1 keeps one bit per button in two words
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day10 [--machines N] [--lights L] [--free F] "
+           "[--max-press P] [--seed S]\n");
+  long long machines = opt_int(argc, argv, "--machines", 171);
+  int max_lights = (int)opt_int(argc, argv, "--lights", 10);
+  int free_vars = (int)opt_int(argc, argv, "--free", 0);
+  int random_free = 1;
+  for (int i = 1; i + 1 < argc; i++)
+    if (strcmp(argv[i], "--free") == 0)
+      random_free = 0;
+  long long max_press = opt_int(argc, argv, "--max-press", 40);
+  if (max_lights < 1 || max_lights > MAX_LIGHTS) {
+    fprintf(stderr, "Error: --lights must be in 1..%d\n", MAX_LIGHTS);
+    return 1;
+  }
+
+  uint64_t buttons[MAX_BUTTONS];
+  for (long long i = 0; i < machines; i++) {
+    int lights = (int)rng_range(&rng, max_lights < 4 ? 1 : 4, max_lights);
+    int f = random_free ? (int)rng_range(&rng, -2, 3) : free_vars;
+    int count = lights + f;
+    if (count < 1)
+      count = 1;
+    if (count > MAX_BUTTONS)
+      count = MAX_BUTTONS;
+
+    uint64_t all = lights == 64 ? ~0ULL : (1ULL << lights) - 1;
+    long long joltage[MAX_LIGHTS] = {0};
+    uint64_t pattern = 0;
+    for (int b = 0; b < count; b++) {
+      do {
+        buttons[b] = rng_next(&rng) & all;
+      } while (buttons[b] == 0);
+      long long presses = rng_range(&rng, 0, max_press);
+      for (int l = 0; l < lights; l++)
+        if (buttons[b] >> l & 1)
+          joltage[l] += presses;
+      if (rng_range(&rng, 0, 1))
+        pattern ^= buttons[b];
+    }
+
+    putchar('[');
+    for (int l = 0; l < lights; l++)
+      putchar(pattern >> l & 1 ? '#' : '.');
+    putchar(']');
+    for (int b = 0; b < count; b++) {
+      const char *sep = " (";
+      for (int l = 0; l < lights; l++)
+        if (buttons[b] >> l & 1) {
+          printf("%s%d", sep, l);
+          sep = ",";
+        }
+      putchar(')');
+    }
+    for (int l = 0; l < lights; l++)
+      printf("%s%lld", l ? "," : " {", joltage[l]);
+    printf("}\n");
+  }
+  return 0;
+}
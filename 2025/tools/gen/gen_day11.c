@@ -0,0 +1,152 @@
+/**
+ * Input generator for Day 11 (Reactor): a device DAG, one
+ * "name: output output ..." line per device that has outputs.
+ * * Devices are placed in a hidden topological order with svr first, you at
+ * 1/10, fft at 1/3, dac at 2/3 and out last (in small graphs, each pushed
+ * one place later if needed to keep them distinct); every edge points
+ * forward by at most --span positions, so the graph is acyclic. Each device but out gets
+ * at least one output, which makes out reachable from everywhere; the other
+ * edges are random and never repeated. The other names are random and
+ * distinct (three letters, more when they run out), and the lines are
+ * shuffled.
+ * * Options:
+ * --nodes N   Number of devices, at least 5 (default 575)
+ * --edges E   Number of edges, at least nodes - 1, at most what the span
+ *             allows (default 1642)
+ * --span S    Longest forward jump in the hidden order (default 40)
+ * --seed S    Random seed (default 1)
+ */
+#include "gen.h"
+
+static const char *const RESERVED[] = {"svr", "you", "fft", "dac", "out"};
+
+typedef struct {
+  int count;
+  int cap;
+  int *to;
+} Outputs;
+
+static int has_edge(const Outputs *o, int v) {
+  for (int i = 0; i < o->count; i++)
+    if (o->to[i] == v)
+      return 1;
+  return 0;
+}
+
+static void add_output(Outputs *o, int v) {
+  if (o->count == o->cap) {
+    o->cap = o->cap ? 2 * o->cap : 4;
+    o->to = realloc(o->to, o->cap * sizeof(int));
+  }
+  o->to[o->count++] = v;
+}
+
+// Name number code in base 26, len letters
+static void write_name(char *out, int code, int len) {
+  for (int i = len - 1; i >= 0; i--) {
+    out[i] = 'a' + code % 26;
+    code /= 26;
+  }
+  out[len] = '\0';
+}
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day11 [--nodes N] [--edges E] [--span S] "
+           "[--seed S]\n");
+  int n = (int)opt_int(argc, argv, "--nodes", 575);
+  long long edges = opt_int(argc, argv, "--edges", 1642);
+  int span = (int)opt_int(argc, argv, "--span", 40);
+  if (n < 5 || span < 1) {
+    fprintf(stderr, "Error: need --nodes >= 5 and --span >= 1\n");
+    return 1;
+  }
+  // Device u can only point at the min(span, n - 1 - u) devices after it
+  long long max_edges = 0;
+  for (int u = 0; u < n - 1; u++)
+    max_edges += n - 1 - u < span ? n - 1 - u : span;
+  if (edges < n - 1 || edges > max_edges) {
+    fprintf(stderr, "Error: need %d <= --edges <= %lld for these nodes "
+                    "and span\n", n - 1, max_edges);
+    return 1;
+  }
+
+  // Names: shuffled codes of the shortest length that has room for all
+  int len = 3;
+  long long codes = 26 * 26 * 26;
+  while (codes < n + 5) {
+    len++;
+    codes *= 26;
+  }
+  if (codes > 1 << 28)
+    codes = 1 << 28; // Plenty, and keeps the shuffle small
+  int *code = malloc(codes * sizeof(int));
+  for (int i = 0; i < codes; i++)
+    code[i] = i;
+  rng_shuffle(&rng, code, (int)codes);
+
+  char **name = malloc(n * sizeof(char *));
+  for (int i = 0; i < n; i++)
+    name[i] = NULL;
+  int special[5] = {0, n / 10, n / 3, 2 * n / 3, n - 1};
+  for (int r = 1; r < 4; r++) // Distinct even for small n
+    if (special[r] <= special[r - 1])
+      special[r] = special[r - 1] + 1;
+  for (int r = 0; r < 5; r++)
+    name[special[r]] = strdup(RESERVED[r]);
+  int next_code = 0;
+  for (int i = 0; i < n; i++) {
+    if (name[i])
+      continue;
+    name[i] = malloc(len + 1);
+    int taken;
+    do {
+      write_name(name[i], code[next_code++], len);
+      taken = 0;
+      for (int r = 0; r < 5; r++)
+        taken |= strcmp(name[i], RESERVED[r]) == 0;
+    } while (taken);
+  }
+  free(code);
+
+  // One forward output per device, then random extra ones
+  Outputs *out = calloc(n, sizeof(Outputs));
+  for (int u = 0; u < n - 1; u++) {
+    int reach = n - 1 - u < span ? n - 1 - u : span;
+    add_output(&out[u], u + (int)rng_range(&rng, 1, reach));
+  }
+  for (long long e = n - 1; e < edges;) {
+    int u = (int)rng_range(&rng, 0, n - 2);
+    int reach = n - 1 - u < span ? n - 1 - u : span;
+    if (out[u].count == reach)
+      continue; // Every reachable output already taken
+    int v = u + (int)rng_range(&rng, 1, reach);
+    if (!has_edge(&out[u], v)) {
+      add_output(&out[u], v);
+      e++;
+    }
+  }
+
+  int *order = malloc((n - 1) * sizeof(int));
+  for (int i = 0; i < n - 1; i++)
+    order[i] = i;
+  rng_shuffle(&rng, order, n - 1);
+  for (int i = 0; i < n - 1; i++) {
+    Outputs *o = &out[order[i]];
+    rng_shuffle(&rng, o->to, o->count);
+    printf("%s:", name[order[i]]);
+    for (int k = 0; k < o->count; k++)
+      printf(" %s", name[o->to[k]]);
+    printf("\n");
+  }
+
+  for (int i = 0; i < n; i++) {
+    free(name[i]);
+    free(out[i].to);
+  }
+  free(name);
+  free(out);
+  free(order);
+  return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * Input generator for Day 2 (Gift Shop): one line of comma-separated ID
+ * ranges "start-end".
+ * * The solvers walk every ID of every range, so --width is the main cost
+ * knob. Starts have a uniformly random number of digits, so short and long
+ * IDs are equally common.
+ * * Options:
+ * --n N        Number of ranges (default 34)
+ * --digits D   Most digits in an ID, at most 18 (default 10)
+ * --width W    Largest range width end - start (default 250000)
+ * --seed S     Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day2 [--n N] [--digits D] [--width W] [--seed S]\n");
+  long long n = opt_int(argc, argv, "--n", 34);
+  int digits = (int)opt_int(argc, argv, "--digits", 10);
+  long long width = opt_int(argc, argv, "--width", 250000);
+  if (digits < 1)
+    digits = 1;
+  if (digits > 18)
+    digits = 18;
+
+  for (long long i = 0; i < n; i++) {
+    int d = (int)rng_range(&rng, 1, digits);
+    long long lo = 1;
+    for (int k = 1; k < d; k++)
+      lo *= 10;
+    long long start = rng_range(&rng, lo, lo * 10 - 1);
+    long long end = start + rng_range(&rng, 0, width);
+    printf("%s%lld-%lld", i ? "," : "", start, end);
+  }
+  printf("\n");
+  return 0;
+}
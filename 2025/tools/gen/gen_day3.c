@@ -0,0 +1,24 @@
+/**
+ * Input generator for Day 3 (Lobby): battery banks, one line of digits 1-9
+ * per bank.
+ * * Options:
+ * --n N        Number of banks (default 200)
+ * --length L   Digits per bank (default 100)
+ * --seed S     Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day3 [--n N] [--length L] [--seed S]\n");
+  long long n = opt_int(argc, argv, "--n", 200);
+  long long length = opt_int(argc, argv, "--length", 100);
+
+  for (long long i = 0; i < n; i++) {
+    for (long long j = 0; j < length; j++)
+      putchar('1' + (int)rng_range(&rng, 0, 8));
+    putchar('\n');
+  }
+  return 0;
+}
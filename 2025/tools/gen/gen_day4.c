@@ -0,0 +1,27 @@
+/**
+ * Input generator for Day 4 (Printing Department): a grid of paper rolls
+ * '@' and empty cells '.'.
+ * * Options:
+ * --width W      Columns (default 139)
+ * --height H     Rows (default 139)
+ * --density P    Fraction of cells holding a roll (default 0.65)
+ * --seed S       Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day4 [--width W] [--height H] [--density P] "
+           "[--seed S]\n");
+  long long width = opt_int(argc, argv, "--width", 139);
+  long long height = opt_int(argc, argv, "--height", 139);
+  double density = opt_real(argc, argv, "--density", 0.65);
+
+  for (long long r = 0; r < height; r++) {
+    for (long long c = 0; c < width; c++)
+      putchar(rng_unit(&rng) < density ? '@' : '.');
+    putchar('\n');
+  }
+  return 0;
+}
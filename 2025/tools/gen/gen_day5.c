@@ -0,0 +1,36 @@
+/**
+ * Input generator for Day 5 (Cafeteria): fresh ID ranges "start-end", a
+ * blank line, then one available ingredient ID per line.
+ * * Range starts and IDs are uniform in [1, max]; range widths are uniform
+ * in [0, 2 * width], so --width is the average width. Ranges may overlap.
+ * * Options:
+ * --ranges N   Number of ranges (default 187)
+ * --ids N      Number of ingredient IDs (default 1000)
+ * --max M      Largest ID (default 562949953421311, 2^49 - 1)
+ * --width W    Average range width (default 2300000000000)
+ * --seed S     Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day5 [--ranges N] [--ids N] [--max M] [--width W] "
+           "[--seed S]\n");
+  long long ranges = opt_int(argc, argv, "--ranges", 187);
+  long long ids = opt_int(argc, argv, "--ids", 1000);
+  long long max = opt_int(argc, argv, "--max", 562949953421311LL);
+  long long width = opt_int(argc, argv, "--width", 2300000000000LL);
+
+  for (long long i = 0; i < ranges; i++) {
+    long long start = rng_range(&rng, 1, max);
+    long long end = start + rng_range(&rng, 0, 2 * width);
+    if (end > max)
+      end = max;
+    printf("%lld-%lld\n", start, end);
+  }
+  printf("\n");
+  for (long long i = 0; i < ids; i++)
+    printf("%lld\n", rng_range(&rng, 1, max));
+  return 0;
+}
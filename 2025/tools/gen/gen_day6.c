@@ -0,0 +1,54 @@
+/**
+ * Input generator for Day 6 (Trash Compactor): rows of numbers above a row
+ * of operators, one problem per block of columns.
+ * * Each problem gets a width of 1..digits columns; one of its numbers uses
+ * the full width, the others are shorter and either all left- or all
+ * right-aligned inside the block. Digits are 1-9, so reading the block by
+ * columns (part 2) never meets an empty column. Blocks are separated by one
+ * blank column and every line is padded to the same length.
+ * * Options:
+ * --problems N   Number of problems (default 1000)
+ * --rows R       Numbers per problem (default 4)
+ * --digits D     Widest number (default 4)
+ * --seed S       Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day6 [--problems N] [--rows R] [--digits D] "
+           "[--seed S]\n");
+  int problems = (int)opt_int(argc, argv, "--problems", 1000);
+  int rows = (int)opt_int(argc, argv, "--rows", 4);
+  int digits = (int)opt_int(argc, argv, "--digits", 4);
+  if (problems < 1 || rows < 1 || digits < 1) {
+    fprintf(stderr, "Error: --problems, --rows and --digits must be > 0\n");
+    return 1;
+  }
+
+  // Lay out every row in memory first, then print them
+  size_t line_len = (size_t)problems * (digits + 1);
+  char *lines = malloc((size_t)(rows + 1) * line_len);
+  memset(lines, ' ', (size_t)(rows + 1) * line_len);
+
+  size_t col = 0;
+  for (int p = 0; p < problems; p++) {
+    int w = (int)rng_range(&rng, 1, digits);
+    int full = (int)rng_range(&rng, 0, rows - 1); // Row using all w columns
+    int right = (int)rng_range(&rng, 0, 1);
+    for (int r = 0; r < rows; r++) {
+      int len = r == full ? w : (int)rng_range(&rng, 1, w);
+      char *cell = lines + (size_t)r * line_len + col + (right ? w - len : 0);
+      for (int d = 0; d < len; d++)
+        cell[d] = '1' + (char)rng_range(&rng, 0, 8);
+    }
+    lines[(size_t)rows * line_len + col] = rng_range(&rng, 0, 1) ? '*' : '+';
+    col += w + 1;
+  }
+
+  for (int r = 0; r <= rows; r++)
+    printf("%.*s\n", (int)(col - 1), lines + (size_t)r * line_len);
+  free(lines);
+  return 0;
+}
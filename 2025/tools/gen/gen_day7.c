@@ -0,0 +1,46 @@
+/**
+ * Input generator for Day 7 (Laboratories): a tachyon manifold with the
+ * start 'S' in the middle of the first row and splitters '^' below it.
+ * * As in the real input, splitters sit on every other row, and the k-th
+ * splitter row (k = 0, 1, ...) only uses the columns S-k, S-k+2, ..., S+k
+ * that a beam can reach. Each of those holds a splitter with probability
+ * --density; the first one is always present.
+ * * Options:
+ * --width W      Columns (default 141)
+ * --height H     Rows (default 142)
+ * --density P    Splitter probability (default 0.67)
+ * --seed S       Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv,
+           "usage: gen_day7 [--width W] [--height H] [--density P] "
+           "[--seed S]\n");
+  int width = (int)opt_int(argc, argv, "--width", 141);
+  int height = (int)opt_int(argc, argv, "--height", 142);
+  double density = opt_real(argc, argv, "--density", 0.67);
+  if (width < 1 || height < 1) {
+    fprintf(stderr, "Error: --width and --height must be > 0\n");
+    return 1;
+  }
+
+  char *row = malloc(width + 1);
+  row[width] = '\0';
+  int start = width / 2;
+  for (int r = 0; r < height; r++) {
+    memset(row, '.', width);
+    if (r == 0) {
+      row[start] = 'S';
+    } else if (r % 2 == 0) {
+      int k = r / 2 - 1;
+      for (int c = start - k; c <= start + k; c += 2)
+        if (c >= 0 && c < width && (k == 0 || rng_unit(&rng) < density))
+          row[c] = '^';
+    }
+    puts(row);
+  }
+  free(row);
+  return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * Input generator for Day 8 (Playground): junction boxes, one "X,Y,Z" per
+ * line with coordinates uniform in [0, max].
+ * * Options:
+ * --n N       Number of junction boxes (default 1000)
+ * --max M     Largest coordinate (default 100000)
+ * --seed S    Random seed (default 1)
+ */
+#include "gen.h"
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv, "usage: gen_day8 [--n N] [--max M] [--seed S]\n");
+  long long n = opt_int(argc, argv, "--n", 1000);
+  long long max = opt_int(argc, argv, "--max", 100000);
+
+  for (long long i = 0; i < n; i++) {
+    long long x = rng_range(&rng, 0, max);
+    long long y = rng_range(&rng, 0, max);
+    long long z = rng_range(&rng, 0, max);
+    printf("%lld,%lld,%lld\n", x, y, z);
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * Input generator for Day 9 (Movie Theater): the red tiles, one "X,Y" per
+ * line, in order around a simple rectilinear polygon.
+ * * The polygon is x-monotone: the x axis is cut into m = n / 4 slabs and
+ * slab i covers the rows [bottom_i, top_i]. The top chain runs left to right
+ * and the bottom chain back, with two corners per slab on each. Neighbouring
+ * slabs overlap strictly and never share a top or bottom, so the outline
+ * never touches itself and no three corners are collinear.
+ * * Options:
+ * --n N       Number of red tiles, rounded down to a multiple of 4
+ *             (default 496)
+ * --max M     Largest coordinate (default 100000)
+ * --seed S    Random seed (default 1)
+ */
+#include "gen.h"
+
+// Uniform in [lo, hi] without skip (the range must hold another value)
+static long long range_except(Rng *rng, long long lo, long long hi,
+                              long long skip) {
+  if (skip < lo || skip > hi)
+    return rng_range(rng, lo, hi);
+  long long v = rng_range(rng, lo, hi - 1);
+  return v >= skip ? v + 1 : v;
+}
+
+int main(int argc, char **argv) {
+  Rng rng;
+  gen_init(&rng, argc, argv, "usage: gen_day9 [--n N] [--max M] [--seed S]\n");
+  long long n = opt_int(argc, argv, "--n", 496);
+  long long max = opt_int(argc, argv, "--max", 100000);
+  long long m = n / 4;
+  if (m < 1 || max < 2 * (m + 1)) {
+    fprintf(stderr, "Error: need --n >= 4 and --max >= n / 2 + 2\n");
+    return 1;
+  }
+
+  // m + 1 distinct x cuts, one per stretch of max / (m + 1) columns
+  long long *x = malloc((m + 1) * sizeof(long long));
+  long long *top = malloc(m * sizeof(long long));
+  long long *bottom = malloc(m * sizeof(long long));
+  long long step = max / (m + 1);
+  for (long long i = 0; i <= m; i++)
+    x[i] = i * step + rng_range(&rng, 0, step - 1);
+
+  // Each slab is drawn against the previous one [b, t] (t >= b + 2): its
+  // bottom below t and its top above both bottoms, skipping b and t. When
+  // t == max the bottom stays below max - 2, so the top has room under max.
+  top[0] = rng_range(&rng, 2, max);
+  bottom[0] = rng_range(&rng, 0, top[0] - 2);
+  for (long long i = 1; i < m; i++) {
+    long long b = bottom[i - 1], t = top[i - 1];
+    bottom[i] = range_except(&rng, 0, t == max ? t - 3 : t - 1, b);
+    long long low = bottom[i] > b ? bottom[i] : b;
+    long long from = low + 1 > bottom[i] + 2 ? low + 1 : bottom[i] + 2;
+    top[i] = range_except(&rng, from, max, t);
+  }
+
+  for (long long i = 0; i < m; i++)
+    printf("%lld,%lld\n%lld,%lld\n", x[i], top[i], x[i + 1], top[i]);
+  for (long long i = m - 1; i >= 0; i--)
+    printf("%lld,%lld\n%lld,%lld\n", x[i + 1], bottom[i], x[i], bottom[i]);
+
+  free(x);
+  free(top);
+  free(bottom);
+  return 0;
+}
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Builds the cached runner, the solver daemon and its client, and every
+# solver (without markers) as dayN_partM, all into one directory.
+# Usage: build.sh [DIR]   (default: tools/run/bin)
+# Rebuilding a solver changes its hash, so the cache never serves an answer
+# from an older build.
+set -e
+
+root=$(cd "$(dirname "$0")/../.." && pwd)
+out=${1:-"$root/tools/run/bin"}
+cc=${CC:-gcc}
+mkdir -p "$out"
+
+for src in "$root"/day*/part*/*.c; do
+  part=$(basename "$(dirname "$src")")
+  day=$(basename "$(dirname "$(dirname "$src")")")
+  $cc -O2 -march=native -pthread $CFLAGS -o "$out/${day}_$part" "$src" -lm
+done
+$cc -O2 -o "$out/run" "$root/tools/run/run.c"
+$cc -O2 -pthread -o "$out/daemon" "$root/tools/run/daemon.c"
+$cc -O2 -o "$out/client" "$root/tools/run/client.c"
+
+echo "Built into $out; run $out/run dayN/partM input.txt, or start"
+echo "$out/daemon and ask it with $out/client dayN/partM input.txt"
@@ -0,0 +1,208 @@
+/**
+ * Client for the solver daemon (daemon.c): sends one input to a solver and
+ * prints the answer, like run does without the daemon.
+ * * With --repeat N it sends the same request N times over one connection and
+ * reports the end-to-end latency on stderr: from writing the request to
+ * having read the whole answer, so it includes the socket round trip that
+ * the daemon's own times leave out. For example:
+ * requests 1000 hit 999 miss 1 solved 0
+ * end-to-end_us median 41 p99 63 min 35 max 180412
+ * daemon_us     median 12 p99 19 min 9 max 180390
+ * The percentiles are nearest rank, as in bench.
+ * * client dayN/partM [INPUT] [--socket PATH] [--repeat N] [--no-cache] [-v]
+ * INPUT defaults to stdin; the socket is found as by the daemon. -v prints
+ * each answer's cache result and times. The exit status is the solver's.
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static long long now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int write_all(int fd, const void *data, size_t len) {
+  const char *p = data;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    len -= n;
+  }
+  return 0;
+}
+
+// Reads the whole file (or stdin) into memory
+static char *read_input(const char *path, size_t *len) {
+  FILE *f = path ? fopen(path, "rb") : stdin;
+  if (!f)
+    return NULL;
+  size_t cap = 1 << 16, used = 0, n;
+  char *buf = malloc(cap);
+  while ((n = fread(buf + used, 1, cap - used, f)) > 0) {
+    used += n;
+    if (used == cap)
+      buf = realloc(buf, cap *= 2);
+  }
+  if (path)
+    fclose(f);
+  *len = used;
+  return buf;
+}
+
+static void default_socket(char *buf, size_t size) {
+  const char *env = getenv("AOC_SOCKET");
+  if (env && *env)
+    snprintf(buf, size, "%s", env);
+  else if ((env = getenv("XDG_RUNTIME_DIR")) && *env)
+    snprintf(buf, size, "%s/aoc-2025.sock", env);
+  else
+    snprintf(buf, size, "/tmp/aoc-2025-%ld.sock", (long)getuid());
+}
+
+static int compare_ll(const void *a, const void *b) {
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+static void print_stats(const char *label, long long *v, int n) {
+  qsort(v, n, sizeof(long long), compare_ll);
+  int p99 = (int)(0.99 * n + 0.999999) - 1; // Nearest rank
+  fprintf(stderr, "%-13s median %lld p99 %lld min %lld max %lld\n", label,
+          v[(n - 1) / 2], v[p99 < 0 ? 0 : p99], v[0], v[n - 1]);
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: client dayN/partM [INPUT] [--socket PATH] "
+                  "[--repeat N] [--no-cache] [-v]\n");
+}
+
+int main(int argc, char **argv) {
+  const char *id = NULL, *input_path = NULL, *socket_arg = NULL;
+  int repeat = 1, no_cache = 0, verbose = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+      socket_arg = argv[++i];
+    else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+      repeat = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--no-cache") == 0)
+      no_cache = 1;
+    else if (strcmp(argv[i], "-v") == 0)
+      verbose = 1;
+    else if (argv[i][0] != '-' && !id)
+      id = argv[i];
+    else if (argv[i][0] != '-' && !input_path)
+      input_path = argv[i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+  if (!id || repeat < 1) {
+    usage();
+    return 1;
+  }
+
+  size_t len;
+  char *input = read_input(input_path, &len);
+  if (!input) {
+    fprintf(stderr, "Error: cannot read input '%s': %s\n", input_path,
+            strerror(errno));
+    return 1;
+  }
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (socket_arg)
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_arg);
+  else
+    default_socket(addr.sun_path, sizeof(addr.sun_path));
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    fprintf(stderr, "Error: cannot connect to '%s': %s\n", addr.sun_path,
+            strerror(errno));
+    return 1;
+  }
+  FILE *in = fdopen(fd, "r");
+  // A daemon that rejects the request closes the socket mid-write: get
+  // EPIPE instead of dying, then read why
+  signal(SIGPIPE, SIG_IGN);
+
+  char header[128];
+  int header_len = snprintf(header, sizeof(header), "%s %zu%s\n", id, len,
+                            no_cache ? " nocache" : "");
+  long long *e2e = malloc(repeat * sizeof(long long));
+  long long *daemon = malloc(repeat * sizeof(long long));
+  int counts[3] = {0}; // hit, miss, solved
+  int status = 0;
+  char *answer = NULL;
+  size_t answer_cap = 0;
+
+  for (int r = 0; r < repeat; r++) {
+    long long start = now_us();
+    char line[256], source[16];
+    if (write_all(fd, header, header_len) != 0 ||
+        write_all(fd, input, len) != 0) {
+      if (fgets(line, sizeof(line), in))
+        fprintf(stderr, "Error: daemon: %s", line);
+      else
+        fprintf(stderr, "Error: the daemon closed the connection\n");
+      return 1;
+    }
+
+    size_t answer_len;
+    long long hash_us, solve_us, total_us;
+    if (!fgets(line, sizeof(line), in)) {
+      fprintf(stderr, "Error: no answer from the daemon\n");
+      return 1;
+    }
+    if (sscanf(line, "answer %d %15s %zu %lld %lld %lld", &status, source,
+               &answer_len, &hash_us, &solve_us, &total_us) != 6) {
+      fprintf(stderr, "Error: daemon: %s", line);
+      return 1;
+    }
+    if (answer_len + 1 > answer_cap)
+      answer = realloc(answer, answer_cap = answer_len + 1);
+    if (fread(answer, 1, answer_len, in) != answer_len) {
+      fprintf(stderr, "Error: answer cut short\n");
+      return 1;
+    }
+    e2e[r] = now_us() - start;
+    daemon[r] = total_us;
+    counts[strcmp(source, "hit") == 0    ? 0
+           : strcmp(source, "miss") == 0 ? 1
+                                         : 2]++;
+
+    if (r == 0)
+      fwrite(answer, 1, answer_len, stdout);
+    if (verbose)
+      fprintf(stderr,
+              "%s: %s status %d hash %lld us solve %lld us daemon %lld us "
+              "end-to-end %lld us\n",
+              id, source, status, hash_us, solve_us, total_us, e2e[r]);
+  }
+  fclose(in);
+
+  if (repeat > 1) {
+    fprintf(stderr, "requests %d hit %d miss %d solved %d\n", repeat,
+            counts[0], counts[1], counts[2]);
+    print_stats("end-to-end_us", e2e, repeat);
+    print_stats("daemon_us", daemon, repeat);
+  }
+  free(e2e);
+  free(daemon);
+  free(answer);
+  free(input);
+  return status;
+}
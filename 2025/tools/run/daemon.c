@@ -0,0 +1,529 @@
+/**
+ * Solver daemon: answers dayN/partM requests over a Unix domain socket.
+ * * It saves what a one-off run pays on every request:
+ * - Warm solvers: one process per solver is started ahead of time and waits,
+ * already loaded, for its input on a pipe. A request hands its input to
+ * that process and a replacement is started once the answer is sent.
+ * - Worker threads: a fixed pool, started with the daemon, takes the
+ * connections; each keeps its input and output buffers across requests.
+ * - The result cache (common/cache.h, the same one tools/run uses), with the
+ * solver hashes computed once and again only when a binary changes.
+ * The solvers themselves are unchanged: their static arrays are still paged
+ * in by each process, so the daemon removes process startup, not that.
+ * * Protocol, any number of requests per connection, answered in order:
+ * request:  "dayN/partM <input bytes> [nocache]\n" followed by the input
+ * response: "answer <exit status> <hit|miss|solved> <output bytes> <hash_us>
+ *           <solve_us> <total_us>\n" followed by the solver's output,
+ *           or "error <message>\n" (the connection is then closed).
+ * The times are measured in the daemon, from the request's last byte.
+ * * Build with build.sh, then:
+ * daemon [--socket PATH] [--bin DIR] [--threads N] [--no-cache]
+ *        [--cache-dir DIR] [--max-entries N] [--max-bytes B]
+ * The socket is $AOC_SOCKET, else $XDG_RUNTIME_DIR/aoc-2025.sock, else
+ * /tmp/aoc-2025-<uid>.sock, created 0600 so only its owner can connect;
+ * --bin and the cache options are as for run.
+ * SIGINT or SIGTERM stops it and removes the socket. Use client to talk to it.
+ */
+#define _GNU_SOURCE // pipe2, accept4
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../common/cache.h"
+#include "../../common/hash.h"
+
+#define PATH_LEN 4096
+#define MAX_SOLVERS 32
+#define MAX_REQUEST (256LL << 20) // Larger requests are refused
+#define MAX_THREADS 64
+
+/**
+ * A solver process started ahead of time: it blocks reading its stdin (the
+ * write end of in) until a request arrives. pid 0: none waiting.
+ */
+typedef struct {
+  pid_t pid;
+  int in;  // Its stdin
+  int out; // Its stdout
+} Warm;
+
+typedef struct {
+  char id[32];         // "dayN/partM"
+  char path[PATH_LEN]; // The binary
+  pthread_mutex_t lock;
+  Warm warm;
+  uint64_t build;        // Hash of the binary...
+  struct timespec mtime; // ...as of this mtime and size
+  off_t size;
+} Solver;
+
+// One connection's read side
+typedef struct {
+  int fd;
+  char buf[4096];
+  size_t pos, end;
+} Conn;
+
+static Solver solvers[MAX_SOLVERS];
+static int num_solvers = 0;
+static Cache cache;
+static int use_cache = 1;
+static int listen_fd = -1;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+static long long now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int write_all(int fd, const void *data, size_t len) {
+  const char *p = data;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    len -= n;
+  }
+  return 0;
+}
+
+// Reads a line without its newline. Returns -1 at end of stream.
+static int read_line(Conn *c, char *line, size_t size) {
+  size_t len = 0;
+  for (;;) {
+    if (c->pos == c->end) {
+      ssize_t n = read(c->fd, c->buf, sizeof(c->buf));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return -1;
+      c->pos = 0;
+      c->end = n;
+    }
+    char ch = c->buf[c->pos++];
+    if (ch == '\n')
+      break;
+    if (len + 1 < size)
+      line[len++] = ch;
+  }
+  line[len] = '\0';
+  return 0;
+}
+
+static int read_exact(Conn *c, char *dst, size_t len) {
+  size_t buffered = c->end - c->pos < len ? c->end - c->pos : len;
+  memcpy(dst, c->buf + c->pos, buffered);
+  c->pos += buffered;
+  for (size_t done = buffered; done < len;) {
+    ssize_t n = read(c->fd, dst + done, len - done);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    done += n;
+  }
+  return 0;
+}
+
+/**
+ * Starts the solver with its stdin and stdout on fresh pipes. Called from
+ * several threads, so the pipes are close-on-exec: no other solver may hold
+ * a copy of this one's stdin, or it would never see the end of its input.
+ * @return 0 on success, -1 on failure.
+ */
+static int spawn(const Solver *s, Warm *w) {
+  int in[2], out[2];
+  if (pipe2(in, O_CLOEXEC) != 0)
+    return -1;
+  if (pipe2(out, O_CLOEXEC) != 0) {
+    close(in[0]);
+    close(in[1]);
+    return -1;
+  }
+  char *const argv[] = {(char *)s->path, NULL};
+  pid_t pid = fork();
+  if (pid == 0) {
+    // Only async-signal-safe calls until exec
+    dup2(in[0], 0);
+    dup2(out[1], 1);
+    execv(argv[0], argv);
+    _exit(127);
+  }
+  close(in[0]);
+  close(out[1]);
+  if (pid < 0) {
+    close(in[1]);
+    close(out[0]);
+    return -1;
+  }
+  *w = (Warm){pid, in[1], out[0]};
+  return 0;
+}
+
+static void discard(Warm *w) {
+  if (w->pid <= 0)
+    return;
+  kill(w->pid, SIGKILL);
+  close(w->in);
+  close(w->out);
+  waitpid(w->pid, NULL, 0);
+  w->pid = 0;
+}
+
+/**
+ * Rehashes the binary if it changed since it was last hashed (rebuilt), and
+ * then also replaces the waiting process, which runs the old build.
+ * Call with s->lock held. @return 0, or -1 if the binary can't be read.
+ */
+static int refresh(Solver *s) {
+  struct stat st;
+  if (stat(s->path, &st) != 0)
+    return -1;
+  if (st.st_size == s->size && st.st_mtim.tv_sec == s->mtime.tv_sec &&
+      st.st_mtim.tv_nsec == s->mtime.tv_nsec)
+    return 0;
+  if (hash64_file(s->path, &s->build) != 0)
+    return -1;
+  s->size = st.st_size;
+  s->mtime = st.st_mtim;
+  discard(&s->warm);
+  return 0;
+}
+
+/**
+ * Feeds the input to a solver process and collects its output into *out
+ * (grown as needed, *cap bytes). Writing and reading are interleaved with
+ * poll(): a solver may print more than a pipe holds before it has read all
+ * its input, and a blocking write would then wait on it forever.
+ * @return The exit status, -1 if it didn't exit normally.
+ */
+static int solve(Warm *w, const char *input, size_t len, char **out,
+                 size_t *cap, size_t *out_len) {
+  int in = w->in;
+  fcntl(in, F_SETFL, O_NONBLOCK);
+  size_t sent = 0, used = 0;
+  if (len == 0) {
+    close(in);
+    in = -1;
+  }
+
+  for (;;) {
+    struct pollfd fds[2] = {{.fd = w->out, .events = POLLIN},
+                            {.fd = in, .events = POLLOUT}};
+    if (poll(fds, in >= 0 ? 2 : 1, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    if (in >= 0 && fds[1].revents) {
+      ssize_t n = write(in, input + sent, len - sent);
+      if (n > 0)
+        sent += n;
+      else if (n < 0 && errno != EAGAIN && errno != EINTR)
+        sent = len; // EPIPE: it exited without reading everything
+      if (sent == len) {
+        close(in);
+        in = -1;
+      }
+    }
+
+    if (fds[0].revents) {
+      if (used == *cap)
+        *out = realloc(*out, *cap *= 2);
+      ssize_t n = read(w->out, *out + used, *cap - used);
+      if (n < 0 && (errno == EINTR || errno == EAGAIN))
+        continue;
+      if (n <= 0)
+        break;
+      used += n;
+    }
+  }
+  if (in >= 0)
+    close(in);
+  close(w->out);
+  *out_len = used;
+
+  int status;
+  while (waitpid(w->pid, &status, 0) < 0)
+    if (errno != EINTR)
+      return -1;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static Solver *find_solver(const char *id) {
+  for (int i = 0; i < num_solvers; i++)
+    if (strcmp(solvers[i].id, id) == 0)
+      return &solvers[i];
+  return NULL;
+}
+
+static void send_error(int fd, const char *message) {
+  char line[256];
+  int n = snprintf(line, sizeof(line), "error %s\n", message);
+  write_all(fd, line, n);
+}
+
+/**
+ * Serves the requests of one connection until the client closes it. input
+ * and output are the worker's buffers, kept across connections.
+ */
+static void serve(int fd, char **input, size_t *input_cap, char **output,
+                  size_t *output_cap) {
+  Conn c = {.fd = fd};
+  char line[256];
+  while (read_line(&c, line, sizeof(line)) == 0) {
+    char id[32], flag[16] = "";
+    long long len;
+    if (sscanf(line, "%31s %lld %15s", id, &len, flag) < 2 || len < 0 ||
+        len > MAX_REQUEST) {
+      send_error(fd, "bad request");
+      return;
+    }
+    Solver *s = find_solver(id);
+    if (!s) {
+      send_error(fd, "unknown solver");
+      return;
+    }
+    if ((size_t)len > *input_cap)
+      *input = realloc(*input, *input_cap = len);
+    if (read_exact(&c, *input, len) != 0)
+      return;
+
+    long long start = now_us();
+    int caching = use_cache && strcmp(flag, "nocache") != 0;
+    CacheKey key = {s->id, 0, 0};
+    pthread_mutex_lock(&s->lock);
+    int ok = refresh(s) == 0;
+    key.build = s->build;
+    pthread_mutex_unlock(&s->lock);
+    if (!ok) {
+      send_error(fd, "solver binary unreadable");
+      return;
+    }
+
+    long long hashed = start;
+    if (caching) {
+      key.input = hash64(*input, len, 0);
+      hashed = now_us();
+      char *answer;
+      size_t answer_len;
+      if (cache_get(&cache, &key, &answer, &answer_len) == 0) {
+        long long end = now_us();
+        int n = snprintf(line, sizeof(line), "answer 0 hit %zu %lld 0 %lld\n",
+                         answer_len, hashed - start, end - start);
+        int sent = write_all(fd, line, n) == 0 &&
+                   write_all(fd, answer, answer_len) == 0;
+        free(answer);
+        if (!sent)
+          return;
+        continue;
+      }
+    }
+
+    // Take the waiting process, or start one if another request has it
+    pthread_mutex_lock(&s->lock);
+    Warm w = s->warm;
+    s->warm.pid = 0;
+    pthread_mutex_unlock(&s->lock);
+    if (w.pid == 0 && spawn(s, &w) != 0) {
+      send_error(fd, "cannot start solver");
+      return;
+    }
+    size_t out_len;
+    int status = solve(&w, *input, len, output, output_cap, &out_len);
+    if (caching && status == 0)
+      cache_put(&cache, &key, *output, out_len);
+    long long end = now_us();
+
+    int n = snprintf(line, sizeof(line), "answer %d %s %zu %lld %lld %lld\n",
+                     status, caching ? "miss" : "solved", out_len,
+                     hashed - start, end - hashed, end - start);
+    int sent = write_all(fd, line, n) == 0 &&
+               write_all(fd, *output, out_len) == 0;
+
+    // Warm up the next one after answering, off the request's latency
+    pthread_mutex_lock(&s->lock);
+    if (s->warm.pid == 0)
+      spawn(s, &s->warm);
+    pthread_mutex_unlock(&s->lock);
+    if (!sent)
+      return;
+  }
+}
+
+static void *worker(void *arg) {
+  (void)arg;
+  size_t input_cap = 1 << 16, output_cap = 1 << 12;
+  char *input = malloc(input_cap), *output = malloc(output_cap);
+  for (;;) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      perror("accept");
+      exit(1);
+    }
+    serve(fd, &input, &input_cap, &output, &output_cap);
+    close(fd);
+  }
+  return NULL;
+}
+
+static void stop(int sig) {
+  (void)sig;
+  unlink(socket_path);
+  for (int i = 0; i < num_solvers; i++)
+    if (solvers[i].warm.pid > 0)
+      kill(solvers[i].warm.pid, SIGKILL);
+  _exit(0);
+}
+
+/**
+ * $AOC_SOCKET, else $XDG_RUNTIME_DIR/aoc-2025.sock, else
+ * /tmp/aoc-2025-<uid>.sock. The client has its own copy of this.
+ */
+static void default_socket(char *buf, size_t size) {
+  const char *env = getenv("AOC_SOCKET");
+  if (env && *env)
+    snprintf(buf, size, "%s", env);
+  else if ((env = getenv("XDG_RUNTIME_DIR")) && *env)
+    snprintf(buf, size, "%s/aoc-2025.sock", env);
+  else
+    snprintf(buf, size, "/tmp/aoc-2025-%ld.sock", (long)getuid());
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: daemon [--socket PATH] [--bin DIR] [--threads N] "
+                  "[--no-cache] [--cache-dir DIR] [--max-entries N] "
+                  "[--max-bytes B]\n");
+}
+
+int main(int argc, char **argv) {
+  const char *bin = NULL, *cache_dir = NULL, *socket_arg = NULL;
+  long max_entries = 1000;
+  long long max_bytes = 64LL << 20;
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+      socket_arg = argv[++i];
+    else if (strcmp(argv[i], "--bin") == 0 && i + 1 < argc)
+      bin = argv[++i];
+    else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+      threads = atol(argv[++i]);
+    else if (strcmp(argv[i], "--no-cache") == 0)
+      use_cache = 0;
+    else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc)
+      cache_dir = argv[++i];
+    else if (strcmp(argv[i], "--max-entries") == 0 && i + 1 < argc)
+      max_entries = atol(argv[++i]);
+    else if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc)
+      max_bytes = atoll(argv[++i]);
+    else {
+      usage();
+      return 1;
+    }
+  }
+  if (threads < 1)
+    threads = 1;
+  if (threads > MAX_THREADS)
+    threads = MAX_THREADS;
+
+  char bin_dir[PATH_LEN];
+  if (!bin) {
+    snprintf(bin_dir, sizeof(bin_dir), "%s", argv[0]);
+    char *slash = strrchr(bin_dir, '/');
+    if (slash)
+      *slash = '\0';
+    else
+      strcpy(bin_dir, ".");
+    bin = bin_dir;
+  }
+
+  if (use_cache) {
+    char dir[CACHE_PATH_LEN];
+    if (!cache_dir)
+      cache_dir = cache_default_dir(dir, sizeof(dir));
+    if (cache_open(&cache, cache_dir, max_entries, max_bytes) != 0) {
+      fprintf(stderr, "Warning: cache unavailable (%s), solving\n",
+              strerror(errno));
+      use_cache = 0;
+    }
+  }
+
+  // Solvers that were built, each hashed and started once
+  signal(SIGPIPE, SIG_IGN);
+  for (int day = 1; day <= 25 && num_solvers < MAX_SOLVERS; day++)
+    for (int part = 1; part <= 2 && num_solvers < MAX_SOLVERS; part++) {
+      Solver *s = &solvers[num_solvers];
+      snprintf(s->path, sizeof(s->path), "%s/day%d_part%d", bin, day, part);
+      if (access(s->path, X_OK) != 0)
+        continue;
+      snprintf(s->id, sizeof(s->id), "day%d/part%d", day, part);
+      pthread_mutex_init(&s->lock, NULL);
+      if (refresh(s) != 0 || spawn(s, &s->warm) != 0) {
+        fprintf(stderr, "Error: cannot start '%s': %s\n", s->path,
+                strerror(errno));
+        return 1;
+      }
+      num_solvers++;
+    }
+  if (num_solvers == 0) {
+    fprintf(stderr, "Error: no solvers in '%s' (run build.sh)\n", bin);
+    return 1;
+  }
+
+  char path[PATH_LEN];
+  if (socket_arg)
+    snprintf(path, sizeof(path), "%s", socket_arg);
+  else
+    default_socket(path, sizeof(path));
+  if (strlen(path) >= sizeof(socket_path)) {
+    fprintf(stderr, "Error: socket path too long: %s\n", path);
+    return 1;
+  }
+  strcpy(socket_path, path);
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  strcpy(addr.sun_path, socket_path);
+  listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  unlink(socket_path); // Left behind by a daemon that was killed
+  // Whoever can connect can make the daemon run solvers: owner only (0600).
+  // No other thread runs yet, so changing the umask here is safe.
+  mode_t mask = umask(0177);
+  int bound =
+      listen_fd >= 0 &&
+      bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+  umask(mask);
+  if (!bound || listen(listen_fd, 128) != 0) {
+    fprintf(stderr, "Error: cannot listen on '%s': %s\n", socket_path,
+            strerror(errno));
+    return 1;
+  }
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  fprintf(stderr, "Serving %d solvers on %s with %ld threads\n", num_solvers,
+          socket_path, threads);
+  pthread_t pool[MAX_THREADS];
+  for (long i = 1; i < threads; i++)
+    pthread_create(&pool[i], NULL, worker, NULL);
+  worker(NULL);
+  return 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * Runs one 2025 solver on an input, through the result cache.
+ * * The input is hashed (XXH64, common/hash.h) straight from its mapping, the
+ * solver binary is hashed the same way, and (dayN/partM, binary hash, input
+ * hash) is looked up in the cache (common/cache.h). On a hit the stored
+ * answer is printed and nothing is solved; on a miss the solver runs with the
+ * input as stdin, its output is printed, and it is stored if the solver
+ * exited with 0. The exit status is the solver's (0 on a hit).
+ * * Build everything with build.sh, then:
+ * run dayN/partM [INPUT] [--bin DIR] [--no-cache] [--cache-dir DIR]
+ *     [--max-entries N] [--max-bytes B] [-v]
+ * INPUT defaults to stdin. --bin is the directory build.sh wrote to (default:
+ * the directory of this program). --no-cache always runs the solver and
+ * leaves the cache untouched. The cache lives in $AOC_CACHE_DIR, else
+ * $XDG_CACHE_HOME/aoc-2025, else ~/.cache/aoc-2025, and keeps at most 1000
+ * entries and 64 MB by default. -v reports hit or miss and the time taken on
+ * stderr.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../common/cache.h"
+#include "../../common/hash.h"
+
+#define PATH_LEN 4096
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * Opens the input as a regular file, so it can be mapped for hashing and
+ * handed to the solver as its stdin. A pipe or terminal on stdin is copied to
+ * an unlinked temporary file first.
+ * @return The descriptor, or -1 on failure.
+ */
+static int open_input(const char *path) {
+  if (path)
+    return open(path, O_RDONLY);
+
+  struct stat st;
+  if (fstat(0, &st) == 0 && S_ISREG(st.st_mode))
+    return dup(0);
+
+  char tmp[] = "/tmp/aoc-run-XXXXXX";
+  int fd = mkstemp(tmp);
+  if (fd < 0)
+    return -1;
+  unlink(tmp);
+  char buf[1 << 16];
+  ssize_t n;
+  while ((n = read(0, buf, sizeof(buf))) > 0)
+    if (write(fd, buf, n) != n) {
+      close(fd);
+      return -1;
+    }
+  if (n < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Hashes the whole input from its mapping
+static int hash_input(int fd, uint64_t *digest) {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return -1;
+  if (st.st_size == 0) {
+    *digest = hash64(NULL, 0, 0);
+    return 0;
+  }
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    return -1;
+  Hash64 h;
+  hash64_init(&h, 0);
+  hash64_update(&h, map, st.st_size);
+  munmap(map, st.st_size);
+  *digest = hash64_final(&h);
+  return 0;
+}
+
+/**
+ * Runs the solver with stdin from in_fd and collects its stdout.
+ * @return The exit status (-1 if it couldn't run or didn't exit normally);
+ * *out is the malloc'd output, NUL terminated, *len its length.
+ */
+static int run_solver(const char *solver, int in_fd, char **out,
+                      size_t *len) {
+  int pipefd[2];
+  if (pipe(pipefd) != 0)
+    return -1;
+  pid_t pid = fork();
+  if (pid < 0)
+    return -1;
+  if (pid == 0) {
+    lseek(in_fd, 0, SEEK_SET);
+    dup2(in_fd, 0);
+    dup2(pipefd[1], 1);
+    close(pipefd[0]);
+    close(pipefd[1]);
+    execl(solver, solver, (char *)NULL);
+    fprintf(stderr, "Error: cannot run '%s': %s\n", solver, strerror(errno));
+    _exit(127);
+  }
+  close(pipefd[1]);
+
+  size_t cap = 256, used = 0;
+  char *buf = malloc(cap);
+  ssize_t n;
+  for (;;) {
+    if (used + 1 == cap)
+      buf = realloc(buf, cap *= 2);
+    n = read(pipefd[0], buf + used, cap - used - 1);
+    if (n > 0)
+      used += n;
+    else if (n == 0 || errno != EINTR)
+      break;
+  }
+  close(pipefd[0]);
+  buf[used] = '\0';
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0)
+    if (errno != EINTR) {
+      free(buf);
+      return -1;
+    }
+  *out = buf;
+  *len = used;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: run dayN/partM [INPUT] [--bin DIR] [--no-cache] "
+                  "[--cache-dir DIR] [--max-entries N] [--max-bytes B] "
+                  "[-v]\n");
+}
+
+int main(int argc, char **argv) {
+  const char *id = NULL, *input = NULL, *bin = NULL, *cache_dir = NULL;
+  long max_entries = 1000;
+  long long max_bytes = 64LL << 20;
+  int use_cache = 1, verbose = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--bin") == 0 && i + 1 < argc)
+      bin = argv[++i];
+    else if (strcmp(argv[i], "--no-cache") == 0)
+      use_cache = 0;
+    else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc)
+      cache_dir = argv[++i];
+    else if (strcmp(argv[i], "--max-entries") == 0 && i + 1 < argc)
+      max_entries = atol(argv[++i]);
+    else if (strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc)
+      max_bytes = atoll(argv[++i]);
+    else if (strcmp(argv[i], "-v") == 0)
+      verbose = 1;
+    else if (argv[i][0] != '-' && !id)
+      id = argv[i];
+    else if (argv[i][0] != '-' && !input)
+      input = argv[i];
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  int day, part;
+  char extra;
+  if (!id || sscanf(id, "day%d/part%d%c", &day, &part, &extra) != 2) {
+    usage();
+    return 1;
+  }
+
+  char bin_dir[PATH_LEN];
+  if (!bin) {
+    snprintf(bin_dir, sizeof(bin_dir), "%s", argv[0]);
+    char *slash = strrchr(bin_dir, '/');
+    if (slash)
+      *slash = '\0';
+    else
+      strcpy(bin_dir, ".");
+    bin = bin_dir;
+  }
+  char solver[PATH_LEN + 32];
+  snprintf(solver, sizeof(solver), "%s/day%d_part%d", bin, day, part);
+
+  double start = now_ms();
+  int in_fd = open_input(input);
+  if (in_fd < 0) {
+    fprintf(stderr, "Error: cannot read input '%s': %s\n",
+            input ? input : "-", strerror(errno));
+    return 1;
+  }
+
+  Cache cache;
+  CacheKey key = {id, 0, 0};
+  if (use_cache) {
+    char dir[CACHE_PATH_LEN];
+    if (!cache_dir)
+      cache_dir = cache_default_dir(dir, sizeof(dir));
+    if (hash64_file(solver, &key.build) != 0) {
+      fprintf(stderr, "Error: cannot read solver '%s': %s\n", solver,
+              strerror(errno));
+      return 1;
+    }
+    if (hash_input(in_fd, &key.input) != 0 ||
+        cache_open(&cache, cache_dir, max_entries, max_bytes) != 0) {
+      fprintf(stderr, "Warning: cache unavailable (%s), solving\n",
+              strerror(errno));
+      use_cache = 0;
+    }
+  }
+
+  char *answer;
+  size_t len;
+  if (use_cache && cache_get(&cache, &key, &answer, &len) == 0) {
+    fwrite(answer, 1, len, stdout);
+    if (verbose)
+      fprintf(stderr, "%s: hit %016llx in %.3f ms\n", id,
+              (unsigned long long)key.input, now_ms() - start);
+    free(answer);
+    close(in_fd);
+    return 0;
+  }
+
+  int status = run_solver(solver, in_fd, &answer, &len);
+  close(in_fd);
+  if (status < 0) {
+    fprintf(stderr, "Error: '%s' didn't exit normally\n", solver);
+    return 1;
+  }
+  fwrite(answer, 1, len, stdout);
+  if (use_cache && status == 0 && cache_put(&cache, &key, answer, len) != 0)
+    fprintf(stderr, "Warning: cannot store the answer: %s\n",
+            strerror(errno));
+  if (verbose && use_cache)
+    fprintf(stderr, "%s: miss %016llx in %.3f ms\n", id,
+            (unsigned long long)key.input, now_ms() - start);
+  else if (verbose)
+    fprintf(stderr, "%s: solved in %.3f ms\n", id, now_ms() - start);
+  free(answer);
+  return status;
+}